@@ -0,0 +1,529 @@
+#include <imgui_app_fw.h>
+#include <imgui_app_fw_capture.h>
+#include <imgui_app_fw_headless.h>
+#include <imgui_app_fw_memory.h>
+#include <imgui_app_fw_stats.h>
+
+#include <imgui.h>
+#include <imgui_internal.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Runs synthetic UI workloads on the headless backend for a fixed number of frames and prints per-frame measurements as JSON.
+//
+//   imgui_app_fw_bench [--frames N] [--warmup N] [--width W] [--height H] [--scenario NAME]... [--replay FILE] [--out FILE] [--list]
+
+namespace
+{
+	struct frame_sample
+	{
+		double	m_cpu_ms		= 0.0;
+		int64_t m_allocations	   = 0;
+		int64_t m_alloc_bytes	   = 0;
+		int64_t m_heap_allocations = 0;
+		int64_t m_vertices		   = 0;
+		int64_t m_indices		   = 0;
+		int64_t m_draw_commands	   = 0;
+		int64_t m_viewports		   = 0;
+	};
+
+	struct scenario
+	{
+		const char* m_name;
+		bool		m_viewports;
+
+		// Builds one frame of UI. May return draw data to measure instead of ImGui::GetDrawData(), used by the replay scenario.
+		ImDrawData* (*m_frame)(int frame);
+	};
+
+	ImDrawData* demo_window_frame(int)
+	{
+		ImGui::ShowDemoWindow();
+		return nullptr;
+	}
+
+	ImDrawData* text_10k_frame(int)
+	{
+		static std::vector<std::string> lines;
+		if (lines.empty())
+		{
+			char buf[128];
+			for (int i = 0; i < 10000; ++i)
+			{
+				std::snprintf(buf, sizeof(buf), "%05d [info] request handled in %d us, payload %d bytes", i, (i * 37) % 1000, (i * 7919) % 65536);
+				lines.emplace_back(buf);
+			}
+		}
+
+		ImGuiViewport* viewport = ImGui::GetMainViewport();
+		ImGui::SetNextWindowPos(viewport->Pos);
+		ImGui::SetNextWindowSize(viewport->Size);
+		ImGui::Begin("Log", nullptr, ImGuiWindowFlags_NoDecoration);
+		for (const std::string& line : lines)
+		{
+			ImGui::TextUnformatted(line.c_str(), line.c_str() + line.size());
+		}
+		ImGui::End();
+		return nullptr;
+	}
+
+	ImDrawData* dense_table_frame(int frame)
+	{
+		constexpr int rows	  = 1000;
+		constexpr int columns = 12;
+
+		ImGuiViewport* viewport = ImGui::GetMainViewport();
+		ImGui::SetNextWindowPos(viewport->Pos);
+		ImGui::SetNextWindowSize(viewport->Size);
+		ImGui::Begin("Table", nullptr, ImGuiWindowFlags_NoDecoration);
+
+		const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+		if (ImGui::BeginTable("dense", columns, flags))
+		{
+			ImGui::TableSetupScrollFreeze(0, 1);
+			for (int c = 0; c < columns; ++c)
+			{
+				char name[16];
+				std::snprintf(name, sizeof(name), "col %d", c);
+				ImGui::TableSetupColumn(name);
+			}
+			ImGui::TableHeadersRow();
+
+			for (int r = 0; r < rows; ++r)
+			{
+				ImGui::TableNextRow();
+				for (int c = 0; c < columns; ++c)
+				{
+					ImGui::TableSetColumnIndex(c);
+					ImGui::Text("%d.%d: %.3f", r, c, float((r * 31 + c * 17 + frame) % 1000) * 0.001f);
+				}
+			}
+			ImGui::EndTable();
+		}
+		ImGui::End();
+		return nullptr;
+	}
+
+	void panel_contents(int index, int frame)
+	{
+		static float values[64][4] = {};
+
+		ImGui::Text("Panel %d, frame %d", index, frame);
+		ImGui::SliderFloat("value", &values[index % 64][0], 0.0f, 1.0f);
+		ImGui::DragFloat3("vector", &values[index % 64][1], 0.01f);
+		ImGui::ProgressBar(float((frame + index * 7) % 100) / 100.0f);
+		ImGui::Button("Apply");
+		ImGui::SameLine();
+		ImGui::Button("Reset");
+
+		float plot[32];
+		for (int i = 0; i < 32; ++i)
+		{
+			plot[i] = float(((i + frame + index) * 13) % 32) / 32.0f;
+		}
+		ImGui::PlotLines("history", plot, 32);
+	}
+
+	ImDrawData* docked_windows_frame(int frame)
+	{
+		constexpr int panel_count = 32;
+
+		ImGuiViewport* viewport = ImGui::GetMainViewport();
+		ImGui::SetNextWindowPos(viewport->Pos);
+		ImGui::SetNextWindowSize(viewport->Size);
+		ImGui::SetNextWindowViewport(viewport->ID);
+		ImGui::Begin(
+			"DockHost", nullptr,
+			ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoDocking | ImGuiWindowFlags_NoBringToFrontOnFocus | ImGuiWindowFlags_NoNavFocus);
+
+		const ImGuiID dockspace_id = ImGui::GetID("BenchDockSpace");
+		if (ImGui::DockBuilderGetNode(dockspace_id) == nullptr)
+		{
+			ImGui::DockBuilderAddNode(dockspace_id, ImGuiDockNodeFlags_DockSpace);
+			ImGui::DockBuilderSetNodeSize(dockspace_id, viewport->Size);
+
+			// split breadth first, panel_count - 1 splits leave panel_count leaves at the end of the list
+			std::vector<ImGuiID> nodes{dockspace_id};
+			for (size_t i = 0; i + 1 < size_t(panel_count); ++i)
+			{
+				ImGuiID a, b;
+				ImGui::DockBuilderSplitNode(nodes[i], (i % 2) ? ImGuiDir_Down : ImGuiDir_Left, 0.5f, &a, &b);
+				nodes.push_back(a);
+				nodes.push_back(b);
+			}
+
+			nodes.erase(nodes.begin(), nodes.end() - panel_count);
+			for (int i = 0; i < panel_count; ++i)
+			{
+				char name[32];
+				std::snprintf(name, sizeof(name), "Panel %d", i);
+				ImGui::DockBuilderDockWindow(name, nodes[i]);
+			}
+			ImGui::DockBuilderFinish(dockspace_id);
+		}
+
+		ImGui::DockSpace(dockspace_id);
+		ImGui::End();
+
+		for (int i = 0; i < panel_count; ++i)
+		{
+			char name[32];
+			std::snprintf(name, sizeof(name), "Panel %d", i);
+			ImGui::Begin(name);
+			panel_contents(i, frame);
+			ImGui::End();
+		}
+		return nullptr;
+	}
+
+	ImDrawData* secondary_viewports_frame(int frame)
+	{
+		constexpr int window_count = 24;
+		constexpr int per_row	   = 6;
+
+		// Outside the main viewport, so each window gets a platform window of its own
+		const ImGuiViewport* main_viewport = ImGui::GetMainViewport();
+		const float			 origin_x	   = main_viewport->Pos.x + main_viewport->Size.x + 50.0f;
+		const float			 origin_y	   = main_viewport->Pos.y + 50.0f;
+
+		for (int i = 0; i < window_count; ++i)
+		{
+			char name[32];
+			std::snprintf(name, sizeof(name), "Viewport %d", i);
+			ImGui::SetNextWindowPos(ImVec2(origin_x + float(i % per_row) * 320.0f, origin_y + float(i / per_row) * 260.0f), ImGuiCond_Always);
+			ImGui::SetNextWindowSize(ImVec2(300.0f, 240.0f), ImGuiCond_Always);
+			ImGui::Begin(name);
+			panel_contents(i, frame);
+			ImGui::End();
+		}
+		return nullptr;
+	}
+
+	ImDrawData* replay_frame(int frame)
+	{
+		const int count = imgui_app_fw::capture::replay_frame_count();
+		return count > 0 ? imgui_app_fw::capture::load_replay_frame(frame % count) : nullptr;
+	}
+
+	const scenario g_scenarios[] = {
+		{"demo_window", false, demo_window_frame},
+		{"text_10k", false, text_10k_frame},
+		{"dense_table", false, dense_table_frame},
+		{"docked_windows", false, docked_windows_frame},
+		{"secondary_viewports", true, secondary_viewports_frame},
+		{"replay", false, replay_frame},
+	};
+
+	void count_draw_data(const ImDrawData* draw_data, frame_sample& sample)
+	{
+		if (draw_data == nullptr || !draw_data->Valid)
+		{
+			return;
+		}
+
+		++sample.m_viewports;
+		for (int i = 0; i < draw_data->CmdListsCount; ++i)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[i];
+			sample.m_vertices += cmd_list->VtxBuffer.Size;
+			sample.m_indices += cmd_list->IdxBuffer.Size;
+			for (const ImDrawCmd& cmd : cmd_list->CmdBuffer)
+			{
+				if (cmd.UserCallback == nullptr)
+				{
+					++sample.m_draw_commands;
+				}
+			}
+		}
+	}
+
+	struct options
+	{
+		int						 m_frames = 300;
+		int						 m_warmup = 10;
+		int						 m_width  = 1920;
+		int						 m_height = 1080;
+		std::vector<std::string> m_scenarios;
+		const char*				 m_replay = nullptr;
+		const char*				 m_out	  = nullptr;
+		bool					 m_list	  = false;
+
+		bool parse(int argc, char** argv)
+		{
+			for (int i = 1; i < argc; ++i)
+			{
+				const char* arg	 = argv[i];
+				const bool	more = i + 1 < argc;
+
+				if (std::strcmp(arg, "--list") == 0)
+				{
+					m_list = true;
+				}
+				else if (more && std::strcmp(arg, "--frames") == 0)
+				{
+					m_frames = std::max(std::atoi(argv[++i]), 1);
+				}
+				else if (more && std::strcmp(arg, "--warmup") == 0)
+				{
+					m_warmup = std::max(std::atoi(argv[++i]), 0);
+				}
+				else if (more && std::strcmp(arg, "--width") == 0)
+				{
+					m_width = std::max(std::atoi(argv[++i]), 1);
+				}
+				else if (more && std::strcmp(arg, "--height") == 0)
+				{
+					m_height = std::max(std::atoi(argv[++i]), 1);
+				}
+				else if (more && std::strcmp(arg, "--scenario") == 0)
+				{
+					m_scenarios.emplace_back(argv[++i]);
+				}
+				else if (more && std::strcmp(arg, "--replay") == 0)
+				{
+					m_replay = argv[++i];
+				}
+				else if (more && std::strcmp(arg, "--out") == 0)
+				{
+					m_out = argv[++i];
+				}
+				else
+				{
+					std::fprintf(stderr, "unknown argument: %s\n", arg);
+					return false;
+				}
+			}
+
+			for (const std::string& name : m_scenarios)
+			{
+				const auto known = [&name](const scenario& s) { return name == s.m_name; };
+				if (std::none_of(std::begin(g_scenarios), std::end(g_scenarios), known))
+				{
+					std::fprintf(stderr, "unknown scenario: %s, valid names are:", name.c_str());
+					for (const scenario& s : g_scenarios)
+					{
+						std::fprintf(stderr, " %s", s.m_name);
+					}
+					std::fprintf(stderr, "\n");
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool selected(const scenario& s) const
+		{
+			// replay only runs when a capture was given
+			if (std::strcmp(s.m_name, "replay") == 0 && m_replay == nullptr)
+			{
+				return false;
+			}
+			return m_scenarios.empty() || std::find(m_scenarios.begin(), m_scenarios.end(), s.m_name) != m_scenarios.end();
+		}
+	};
+
+	struct scenario_result
+	{
+		const scenario*					   m_scenario = nullptr;
+		std::vector<frame_sample>		   m_samples;
+		imgui_app_fw::frame_stats::summary m_phases[int(imgui_app_fw::frame_stats::phase::count)];
+	};
+
+	bool run_scenario(const options& opts, const scenario& s, scenario_result& result)
+	{
+		using clock = std::chrono::steady_clock;
+
+		imgui_app_fw::select_platform(imgui_app_fw::platform::headless);
+		imgui_app_fw::set_headless_display_size(opts.m_width, opts.m_height);
+		imgui_app_fw::set_headless_delta_time(1.0f / 60.0f);
+		imgui_app_fw::set_headless_viewports(s.m_viewports);
+
+		if (!imgui_app_fw::init())
+		{
+			return false;
+		}
+
+		const ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
+
+		result.m_scenario = &s;
+		result.m_samples.clear();
+		result.m_samples.reserve(size_t(opts.m_frames));
+
+		for (int frame = 0; frame < opts.m_warmup + opts.m_frames && imgui_app_fw::pump(); ++frame)
+		{
+			if (frame == opts.m_warmup)
+			{
+				imgui_app_fw::frame_stats::reset();
+			}
+
+			const auto start = clock::now();
+
+			imgui_app_fw::begin_frame();
+			ImDrawData* draw_data = s.m_frame(frame);
+			imgui_app_fw::end_frame(clear_color);
+
+			const auto end = clock::now();
+
+			if (frame < opts.m_warmup)
+			{
+				continue;
+			}
+
+			const imgui_app_fw::memory::frame_counters allocations = imgui_app_fw::memory::last_frame_total();
+
+			frame_sample sample;
+			sample.m_cpu_ms			  = std::chrono::duration<double, std::milli>(end - start).count();
+			sample.m_allocations	  = allocations.m_allocations;
+			sample.m_alloc_bytes	  = allocations.m_bytes;
+			sample.m_heap_allocations = allocations.m_heap_allocations;
+
+			count_draw_data(draw_data ? draw_data : ImGui::GetDrawData(), sample);
+			ImGuiPlatformIO& platform_io = ImGui::GetPlatformIO();
+			for (int i = 1; i < platform_io.Viewports.Size; ++i)
+			{
+				count_draw_data(platform_io.Viewports[i]->DrawData, sample);
+			}
+
+			result.m_samples.push_back(sample);
+		}
+
+		for (int p = 0; p < int(imgui_app_fw::frame_stats::phase::count); ++p)
+		{
+			result.m_phases[p] = imgui_app_fw::frame_stats::query(imgui_app_fw::frame_stats::phase(p), opts.m_frames);
+		}
+
+		imgui_app_fw::destroy();
+		return true;
+	}
+
+	template<typename T>
+	void write_series(std::FILE* f, const char* name, const std::vector<frame_sample>& samples, T frame_sample::*member, bool last = false)
+	{
+		std::vector<double> values;
+		values.reserve(samples.size());
+		for (const frame_sample& s : samples)
+		{
+			values.push_back(double(s.*member));
+		}
+
+		double total = 0.0;
+		for (double v : values)
+		{
+			total += v;
+		}
+
+		std::vector<double> sorted = values;
+		std::sort(sorted.begin(), sorted.end());
+
+		const auto percentile = [&sorted](double p) -> double {
+			return sorted.empty() ? 0.0 : sorted[std::min(sorted.size() - 1, size_t(double(sorted.size()) * p))];
+		};
+
+		std::fprintf(
+			f, "        \"%s\": {\"avg\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p99\": %.4f, \"max\": %.4f, \"frames\": [", name,
+			values.empty() ? 0.0 : total / double(values.size()), sorted.empty() ? 0.0 : sorted.front(), percentile(0.5), percentile(0.99),
+			sorted.empty() ? 0.0 : sorted.back());
+
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			std::fprintf(f, i ? ", %.4g" : "%.4g", values[i]);
+		}
+		std::fprintf(f, "]}%s\n", last ? "" : ",");
+	}
+
+	void write_json(std::FILE* f, const options& opts, const std::vector<scenario_result>& results)
+	{
+		std::fprintf(f, "{\n");
+		std::fprintf(f, "  \"frames\": %d,\n  \"warmup\": %d,\n  \"width\": %d,\n  \"height\": %d,\n", opts.m_frames, opts.m_warmup, opts.m_width, opts.m_height);
+		std::fprintf(f, "  \"scenarios\": [\n");
+
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const scenario_result& r = results[i];
+
+			std::fprintf(f, "    {\n      \"name\": \"%s\",\n", r.m_scenario->m_name);
+			std::fprintf(f, "      \"phases_avg_ms\": {");
+			for (int p = 0; p < int(imgui_app_fw::frame_stats::phase::count); ++p)
+			{
+				std::fprintf(f, "%s\"%s\": %.4f", p ? ", " : "", imgui_app_fw::frame_stats::phase_name(imgui_app_fw::frame_stats::phase(p)), r.m_phases[p].m_avg_ms);
+			}
+			std::fprintf(f, "},\n      \"metrics\": {\n");
+
+			write_series(f, "cpu_ms", r.m_samples, &frame_sample::m_cpu_ms);
+			write_series(f, "allocations", r.m_samples, &frame_sample::m_allocations);
+			write_series(f, "alloc_bytes", r.m_samples, &frame_sample::m_alloc_bytes);
+			write_series(f, "heap_allocations", r.m_samples, &frame_sample::m_heap_allocations);
+			write_series(f, "vertices", r.m_samples, &frame_sample::m_vertices);
+			write_series(f, "indices", r.m_samples, &frame_sample::m_indices);
+			write_series(f, "draw_commands", r.m_samples, &frame_sample::m_draw_commands);
+			write_series(f, "viewports", r.m_samples, &frame_sample::m_viewports, true);
+
+			std::fprintf(f, "      }\n    }%s\n", i + 1 < results.size() ? "," : "");
+		}
+
+		std::fprintf(f, "  ]\n}\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	options opts;
+	if (!opts.parse(argc, argv))
+	{
+		return 1;
+	}
+
+	if (opts.m_list)
+	{
+		for (const scenario& s : g_scenarios)
+		{
+			std::printf("%s\n", s.m_name);
+		}
+		return 0;
+	}
+
+	if (opts.m_replay && !imgui_app_fw::capture::open_replay(opts.m_replay))
+	{
+		std::fprintf(stderr, "could not open capture: %s\n", opts.m_replay);
+		return 1;
+	}
+
+	std::vector<scenario_result> results;
+	for (const scenario& s : g_scenarios)
+	{
+		if (!opts.selected(s))
+		{
+			continue;
+		}
+
+		results.emplace_back();
+		if (!run_scenario(opts, s, results.back()))
+		{
+			std::fprintf(stderr, "scenario %s failed to initialize\n", s.m_name);
+			return 1;
+		}
+	}
+
+	std::FILE* out = opts.m_out ? std::fopen(opts.m_out, "w") : stdout;
+	if (out == nullptr)
+	{
+		std::fprintf(stderr, "could not open %s\n", opts.m_out);
+		return 1;
+	}
+
+	write_json(out, opts, results);
+
+	if (out != stdout)
+	{
+		std::fclose(out);
+	}
+
+	imgui_app_fw::capture::close_replay();
+	return 0;
+}
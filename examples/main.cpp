@@ -1,5 +1,8 @@
 #include <imgui_app_fw.h>
+#include <imgui_app_fw_fonts.h>
+#include <imgui_app_fw_memory.h>
 #include <imgui_app_fw_rendering.h>
+#include <imgui_app_fw_stats.h>
 
 //struct custom_scene
 //{
@@ -61,9 +64,12 @@ int main(int, char**)
 {
 	if (imgui_app_fw::select_platform(imgui_app_fw::platform::glfw_vulkan))
 	{
+		imgui_app_fw::set_threaded_rendering(true);
+
 		if (imgui_app_fw::init())
 		{
 			imgui_app_fw::set_window_title("Hello!");
+			imgui_app_fw::set_idle_mode(true);
 
 			// Our state
 			bool   show_demo_window	   = true;
@@ -91,6 +97,12 @@ int main(int, char**)
 					ImGui::Checkbox("Demo Window", &show_demo_window); // Edit bools storing our window open/close state
 					ImGui::Checkbox("Another Window", &show_another_window);
 
+					static bool cache_demo_window = false;
+					if (ImGui::Checkbox("Cache Demo Window", &cache_demo_window))
+					{
+						imgui_app_fw::cache_window("Dear ImGui Demo", cache_demo_window);
+					}
+
 					ImGui::SliderFloat("float", &f, 0.0f, 1.0f);			// Edit 1 float using a slider from 0.0f to 1.0f
 					ImGui::ColorEdit3("clear color", (float*)&clear_color); // Edit 3 floats representing a color
 
@@ -103,6 +115,71 @@ int main(int, char**)
 					ImGui::Text("counter = %d", counter);
 
 					ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+
+					for (int p = 0; p < int(imgui_app_fw::frame_stats::phase::count); ++p)
+					{
+						const auto phase = imgui_app_fw::frame_stats::phase(p);
+						const auto stats = imgui_app_fw::frame_stats::query(phase, 120);
+						ImGui::Text("%-10s avg %.3f ms, p99 %.3f ms", imgui_app_fw::frame_stats::phase_name(phase), stats.m_avg_ms, stats.m_p99_ms);
+					}
+
+					const auto draws = imgui_app_fw::frame_stats::last_frame_draws();
+					ImGui::Text("%lld draw commands in %lld draws", (long long)draws.m_commands, (long long)draws.m_draws);
+					ImGui::Text("geometry %.1f KB written, %.1f KB from cache", draws.m_geometry_written / 1024.0, draws.m_geometry_reused / 1024.0);
+
+					const auto allocations = imgui_app_fw::memory::last_frame_total();
+					const auto heap		   = imgui_app_fw::memory::current_heap();
+					ImGui::Text("%lld allocations (%lld bytes), %lld from the heap", (long long)allocations.m_allocations, (long long)allocations.m_bytes, (long long)allocations.m_heap_allocations);
+					ImGui::Text("%lld KB live, %lld KB peak, %lld KB reserved", (long long)(heap.m_live_bytes / 1024), (long long)(heap.m_peak_live_bytes / 1024), (long long)(heap.m_reserved_bytes / 1024));
+
+					if (ImGui::TreeNode("Startup"))
+					{
+						imgui_app_fw::startup::step steps[imgui_app_fw::startup::max_steps];
+						const int					count = imgui_app_fw::startup::query(steps, imgui_app_fw::startup::max_steps);
+
+						ImGui::Text("%.1f ms to first frame", imgui_app_fw::startup::time_to_first_frame_ms());
+						for (int i = 0; i < count; ++i)
+						{
+							ImGui::Text("%7.1f ms %7.1f ms  [%d] %s", steps[i].m_start_ms, steps[i].m_end_ms - steps[i].m_start_ms, steps[i].m_thread, steps[i].m_name);
+						}
+						ImGui::TreePop();
+					}
+
+					if (ImGui::TreeNode("GPU"))
+					{
+						bool gpu_timing	   = imgui_app_fw::gpu_timing::enabled();
+						bool per_draw_list = imgui_app_fw::gpu_timing::per_draw_list();
+						if (ImGui::Checkbox("Timestamps", &gpu_timing) | ImGui::Checkbox("Per draw list", &per_draw_list))
+						{
+							imgui_app_fw::gpu_timing::set_enabled(gpu_timing, per_draw_list);
+						}
+
+						imgui_app_fw::gpu_timing::span spans[64];
+						const int					   count = imgui_app_fw::gpu_timing::last_frame(spans, IM_ARRAYSIZE(spans));
+
+						ImGui::Text("%.3f ms of render passes", imgui_app_fw::gpu_timing::last_frame_ms());
+						for (int i = 0; i < count; ++i)
+						{
+							ImGui::Text("%*s%08x %s %.3f ms", spans[i].m_depth * 2, "", spans[i].m_viewport_id, spans[i].m_name, spans[i].m_end_ms - spans[i].m_start_ms);
+						}
+
+						if (ImGui::Button("Save gpu_trace.json"))
+						{
+							if (std::FILE* out = std::fopen("gpu_trace.json", "w"))
+							{
+								imgui_app_fw::gpu_timing::write_chrome_trace(out);
+								std::fclose(out);
+							}
+						}
+						ImGui::TreePop();
+					}
+					if (ImGui::TreeNode("Fonts"))
+					{
+						const imgui_app_fw::fonts::cache_state fonts = imgui_app_fw::fonts::current_state();
+						ImGui::Text("%d requested glyphs, %d evicted", fonts.m_glyphs, fonts.m_evictions);
+						ImGui::Text("%d rebuilds, atlas %.2f MB", fonts.m_rebuilds, fonts.m_atlas_bytes / (1024.0 * 1024.0));
+						ImGui::TreePop();
+					}
 					ImGui::End();
 				}
 
@@ -0,0 +1,83 @@
+#include <imgui_app_fw_app.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+// Several independent windows in one process sharing the device, pipeline and font atlas, each rendered by its own render
+// thread. GLFW creates windows and processes their events on the main thread only, so the main thread drives every window
+// and builds their UIs in turn.
+//
+//   imgui_multi_app_example [count]
+
+namespace
+{
+	struct monitor
+	{
+		imgui_app_fw::app m_app;
+		char			  m_title[64] = {};
+		int				  m_frame	  = 0;
+		bool			  m_running	  = false;
+
+		bool init(int index)
+		{
+			std::snprintf(m_title, sizeof(m_title), "Monitor %d", index);
+			m_running = m_app.init(m_title, 640, 480);
+			return m_running;
+		}
+
+		// One frame, false once the window was closed
+		bool run_frame()
+		{
+			if (!m_app.pump())
+			{
+				m_running = false;
+				m_app.destroy();
+				return false;
+			}
+
+			m_app.begin_frame();
+
+			ImGui::SetNextWindowPos(ImVec2(20, 20), ImGuiCond_FirstUseEver);
+			ImGui::Begin(m_title);
+			ImGui::Text("frame %d", m_frame++);
+			ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+			ImGui::ProgressBar(float(m_frame % 240) / 239.0f);
+			if (ImGui::Button("Close"))
+			{
+				m_app.request_quit();
+			}
+			ImGui::End();
+
+			m_app.end_frame(ImVec4(0.45f, 0.55f, 0.60f, 1.00f));
+			return true;
+		}
+	};
+}
+
+int main(int argc, char** argv)
+{
+	const int count = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 3;
+
+	std::vector<std::unique_ptr<monitor>> monitors;
+	for (int i = 0; i < count; ++i)
+	{
+		monitors.push_back(std::make_unique<monitor>());
+		monitors.back()->init(i);
+	}
+
+	for (bool running = true; running;)
+	{
+		running = false;
+		for (std::unique_ptr<monitor>& m : monitors)
+		{
+			running = (m->m_running && m->run_frame()) || running;
+		}
+	}
+
+	return 0;
+}
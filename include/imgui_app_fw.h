@@ -9,6 +9,15 @@ namespace imgui_app_fw
 		win32_dx11,
 		win32_dx12,
 		glfw_vulkan,
+		headless,
+	};
+
+	enum class present_mode
+	{
+		fifo,		  // waits for vertical blank, never tears; the lowest power
+		fifo_relaxed, // like fifo, but a frame that missed its vertical blank is shown at once and may tear
+		mailbox,	  // never tears, a newer frame replaces the one waiting to be shown; low latency
+		immediate,	  // shown at once and may tear; the lowest latency
 	};
 	
 	bool select_platform(platform p);
@@ -19,4 +28,45 @@ namespace imgui_app_fw
 	void begin_frame();
 	void end_frame(ImVec4 clear_color);
 	void destroy();
+	void request_quit();
+
+	// Idle mode: pump() blocks until input, request_redraw() or a request_redraw_at() deadline,
+	// then keeps returning for linger_frames frames so ImGui animations can settle.
+	void set_idle_mode(bool enabled, int linger_frames = 3);
+	void request_redraw();
+	void request_redraw_at(double seconds_from_now);
+
+	// Must be called before init(). end_frame() hands a copy of the draw data to a render thread that records, submits
+	// and presents it while the next frame is built. Draw callbacks then run on the render thread, and the FrameGraph
+	// must only be used from them. Platforms without a render thread ignore this.
+	void set_threaded_rendering(bool enabled);
+
+	// On by default. A viewport whose draw data is identical to what it last presented is neither recorded nor presented,
+	// and the whole submission is skipped when nothing changed. A frame that presents nothing sleeps out the primary
+	// monitor's refresh period in end_frame(), in place of the vsync wait it skipped. Only the GLFW/Vulkan backend does this.
+	void set_skip_unchanged_frames(bool enabled);
+
+	// On by default. Draw lists whose vertices and indices were identical in two consecutive frames move into a GPU-local
+	// buffer and are drawn from there while they stay unchanged, so each frame writes only the geometry that changed. Only
+	// the GLFW/Vulkan backend does this.
+	void set_geometry_cache(bool enabled);
+
+	// Must be called before init(). How many frames the renderer may record ahead of the GPU, each with its own geometry
+	// and uniform buffers, clamped to 1..8. The default of 3 lets the CPU record one frame while the GPU draws the
+	// previous ones; 1 minimizes memory and latency. Only the GLFW/Vulkan backend reads this.
+	void set_frames_in_flight(int count);
+
+	// Must be called before init(). Swapchains prefer this mode and fall back to fifo, which every surface supports, when
+	// the surface doesn't have it. fifo is the default. Only the GLFW/Vulkan backend reads this.
+	void set_present_mode(present_mode mode);
+
+	// Must be called before init(). At most count frames, clamped to 1..4, wait for presentation, which bounds input latency
+	// to about that many refreshes in fifo modes; the swapchain has one image more. Defaults to 1. Only the GLFW/Vulkan
+	// backend reads this.
+	void set_max_queued_frames(int count);
+
+	// end_frame() of the init()/pump() API waits until 1/frames_per_second has passed since the previous frame, 0 (the
+	// default) disables it. It sleeps while the remaining time exceeds how late sleeps have been waking up and spins the
+	// rest, so frames are paced to a fraction of a millisecond without keeping a core busy. Works on every platform.
+	void set_frame_rate_limit(double frames_per_second);
 }
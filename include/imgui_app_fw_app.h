@@ -0,0 +1,43 @@
+#pragma once
+
+#include "imgui_app_fw.h"
+
+namespace imgui_app_fw
+{
+	struct app_backend;
+
+	// An independent UI with its own ImGui context, window and render thread. Every app, and the init()/pump() API, shares
+	// one Vulkan device, FrameGraph, pipeline and font atlas, which live until the last of them is destroyed. Apps always
+	// use the GLFW/Vulkan platform, whatever select_platform() chose, and init() fails in builds without it.
+	//
+	// Apps don't build their UIs in parallel. GLFW creates windows, processes events and reads input on the main thread
+	// only, on every platform, so init(), pump(), begin_frame() and end_frame() of every app must be called from the main
+	// thread, which builds the apps' frames one after another. Only recording, submission and present overlap, on the apps'
+	// render threads. ImGui's current context is a process-wide global that begin_frame() sets and end_frame() restores;
+	// outside a frame, call ImGui::SetCurrentContext(context()) before making ImGui calls for an app.
+	//
+	// Idle mode, captures, frame_stats::commit_frame() and the memory counters stay with the init()/pump() API; phase
+	// timings and allocation counts of apps are added into the same totals.
+	class app
+	{
+	public:
+		app() = default;
+		~app();
+
+		app(const app&) = delete;
+		app& operator=(const app&) = delete;
+
+		bool init(const char* title, int width = 1280, int height = 800);
+		bool pump();
+		void begin_frame();
+		void end_frame(ImVec4 clear_color);
+		void destroy();
+		void request_quit();
+		void set_window_title(const char* title);
+
+		ImGuiContext* context() const;
+
+	private:
+		app_backend* m_backend = nullptr;
+	};
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "imgui_app_fw.h"
+
+namespace imgui_app_fw
+{
+	namespace capture
+	{
+		// Appends the main viewport's draw data to a binary capture file on every end_frame(). The frame table is written by
+		// stop_recording(), a capture that was never stopped has no readable frames.
+		bool start_recording(const char* path);
+		void stop_recording();
+		bool is_recording();
+
+		// Maps a capture file for replay, frames are decoded on demand
+		bool open_replay(const char* path);
+		void close_replay();
+		int	 replay_frame_count();
+
+		// Decodes a recorded frame. The next end_frame() renders it in place of whatever the application built, on any backend.
+		// The result can also be handed to a renderer directly and stays valid until the next call or close_replay().
+		// Draw callbacks are not recorded, and texture ids other than the font atlas replay as null.
+		ImDrawData* load_replay_frame(int index);
+	}
+}
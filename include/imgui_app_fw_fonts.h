@@ -0,0 +1,49 @@
+#pragma once
+
+#include "imgui_app_fw.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace imgui_app_fw
+{
+	// ImGui rasterizes every glyph in a font's ranges when it builds the atlas, so a font covering CJK costs seconds and tens
+	// of megabytes at startup whether or not the glyphs are drawn. A font added here starts with the default Latin ranges
+	// and gains a glyph when text containing it is requested. The atlas is rebuilt between frames when requests are pending,
+	// and the renderer uploads only the rows of the texture that changed. A glyph requested during a frame is drawn from the
+	// next frame on; until then ImGui draws the fallback character.
+	//
+	// ImGui of this version has no way to add a glyph to a built atlas, so every rebuild packs and rasterizes all fonts again.
+	// This costs time in proportion to the glyphs in the atlas, not those in the font file.
+	//
+	// Fonts added to io.Fonts directly after init() are also picked up at the next rebuild. Only the GLFW/Vulkan platform
+	// rebuilds; the others keep the atlas built by init().
+	namespace fonts
+	{
+		struct cache_state
+		{
+			int		m_glyphs	 = 0; // requested glyphs in the atlas, besides the default ranges
+			int		m_rebuilds	 = 0;
+			int		m_evictions	 = 0; // glyphs dropped to stay under the budget
+			int64_t m_atlas_bytes = 0; // alpha and RGBA pixels held by the atlas
+		};
+
+		// Adds a font whose glyphs outside the default ranges are rasterized on request. config->GlyphRanges is replaced.
+		// Call between frames, also while the render thread may be uploading the atlas.
+		ImFont* add_font_from_file(const char* filename, float size_pixels, const ImFontConfig* config = nullptr);
+		ImFont* add_font_from_memory(void* ttf_data, int ttf_size, float size_pixels, const ImFontConfig* config = nullptr);
+
+		// Makes the glyphs of UTF-8 text available to every on-demand font. Cheap for glyphs already in the atlas, so it can
+		// be called every frame for the text about to be drawn, which also keeps it from being evicted. Safe to call from
+		// any thread.
+		void request(const char* text, const char* text_end = nullptr);
+		void request_range(ImWchar first, ImWchar last);
+
+		// When a rebuilt atlas holds more than bytes of pixels, the glyphs requested longest ago are dropped and the atlas
+		// is rebuilt again. Glyphs requested since the last rebuild are never dropped. 0, the default, is no limit.
+		void   set_memory_budget(size_t bytes);
+		size_t memory_budget();
+
+		cache_state current_state();
+	}
+}
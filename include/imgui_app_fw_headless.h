@@ -0,0 +1,25 @@
+#pragma once
+
+#include "imgui_app_fw.h"
+
+namespace imgui_app_fw
+{
+	struct headless_framebuffer
+	{
+		const ImU32* m_pixels = nullptr; // IM_COL32 packed, m_width pixels per row
+		int			 m_width  = 0;
+		int			 m_height = 0;
+	};
+
+	// Must be called before init(); defaults to 1280x800
+	void set_headless_display_size(int width, int height);
+
+	// Must be called before init(). Secondary viewports then live in memory and are rasterized like the main one.
+	void set_headless_viewports(bool enabled);
+
+	// 0 uses the wall clock, anything else advances ImGui time by a fixed step per frame
+	void set_headless_delta_time(float seconds);
+
+	// Valid until the next end_frame()
+	headless_framebuffer get_headless_framebuffer();
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// IMGUI_USER_CONFIG of the imgui library built alongside imgui_app_fw when IMGUI_APP_32BIT_INDICES is on. imgui, the
+// framework and everything linking them compile with it, so they agree on the layout of ImDrawList and ImDrawData.
+#if IMGUI_APP_32BIT_INDICES
+#define ImDrawIdx unsigned int
+#endif
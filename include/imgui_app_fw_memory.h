@@ -0,0 +1,35 @@
+#pragma once
+
+#include "imgui_app_fw_stats.h"
+
+#include <cstdint>
+
+namespace imgui_app_fw
+{
+	namespace memory
+	{
+		// init() routes ImGui allocations through size-class pools, so ImVector growth and other ImGui allocations stop
+		// reaching malloc once the pools are warm. Pool memory is kept for reuse and not handed back to the system.
+		struct frame_counters
+		{
+			int64_t m_allocations	   = 0;
+			int64_t m_bytes			   = 0;
+			int64_t m_heap_allocations = 0; // pool refills and blocks too large for a pool, each one is a malloc
+		};
+
+		struct heap_state
+		{
+			int64_t m_live_bytes	  = 0;
+			int64_t m_peak_live_bytes = 0;
+			int64_t m_reserved_bytes  = 0; // held by the pools, used or not
+		};
+
+		// ImGui allocations of the last completed frame, by the frame_stats phase running on the allocating thread.
+		// phase::frame collects everything outside the measured phases. Safe to call from any thread.
+		frame_counters last_frame(frame_stats::phase p);
+		frame_counters last_frame_total();
+
+		heap_state current_heap();
+		void	   reset_peak();
+	}
+}
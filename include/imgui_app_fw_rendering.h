@@ -31,5 +31,20 @@ namespace imgui_app_fw
 		}
 	};
 
+	// Pipelines can be created from GLSL only when IMGUI_APP_RUNTIME_SHADER_COMPILER is defined, otherwise no pipeline
+	// compiler is registered and pipelines must be SPIR-V with their layout filled in.
 	FG::IFrameGraph* get_framegraph_instance();
+
+	// Makes an image drawable through ImGui::Image() and ImDrawList::AddImage() and returns its ImTextureID, or nullptr when
+	// all 255 slots are taken. The image must stay alive until it is unregistered; an unregistered ImTextureID draws the
+	// font atlas. Safe to call from any thread, including draw callbacks.
+	ImTextureID register_texture(FG::RawImageID image);
+	void		unregister_texture(ImTextureID texture);
+
+	// Draws the window named name, and each of its child windows, into an image of its own that is redrawn only when the
+	// window's draw list changes or its size or framebuffer scale does, and otherwise shows it as one textured quad. A
+	// window that only moved is not redrawn. Meant for dense windows that are mostly static, such as large tables, node
+	// graphs and plots. A window whose list has draw callbacks is drawn as usual. Each cached window takes a texture slot
+	// while it is visible. Takes effect with the next frame, safe to call from any thread.
+	void cache_window(const char* name, bool enabled = true);
 }
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+namespace imgui_app_fw
+{
+	namespace frame_stats
+	{
+		enum class phase : int
+		{
+			frame,	   // end_frame to end_frame
+			pump,	   // platform event polling
+			idle,	   // blocked in pump() while idle mode waits for input
+			new_frame, // begin_frame: input polling and ImGui::NewFrame
+			ui_build,  // application code between begin_frame and end_frame
+			render,	   // ImGui::Render
+			draw,	   // renderer task building (imgui_renderer::draw, write_geometry) or CPU rasterization
+			execute,   // FrameGraph Execute
+			present,   // FrameGraph Flush, which submits and presents
+			count
+		};
+
+		static constexpr int history_size = 512;
+
+		struct summary
+		{
+			int	   m_frames	 = 0;
+			double m_last_ms = 0.0;
+			double m_min_ms	 = 0.0;
+			double m_avg_ms	 = 0.0;
+			double m_p99_ms	 = 0.0;
+			double m_max_ms	 = 0.0;
+		};
+
+		// ImDrawCmds handed to the renderer and the draws it recorded for them after merging, summed over viewports, and the
+		// bytes of geometry written for them against those drawn from the geometry cache without being written
+		struct draw_counters
+		{
+			int64_t m_commands		   = 0;
+			int64_t m_draws			   = 0;
+			int64_t m_geometry_written = 0;
+			int64_t m_geometry_reused  = 0;
+		};
+
+		const char* phase_name(phase p);
+
+		// Statistics over the most recent committed frames (at most history_size - 1). Safe to call from any thread.
+		summary query(phase p, int frames = history_size);
+		void	reset();
+
+		// Of the last committed frame. Only the GLFW/Vulkan renderer reports draws.
+		draw_counters last_frame_draws();
+
+		// Instrumentation. Durations added from any thread accumulate into the frame being built and are published by commit_frame().
+		void add(phase p, int64_t nanoseconds);
+		void add_draws(int64_t commands, int64_t draws);
+		void add_geometry(int64_t written_bytes, int64_t reused_bytes);
+		void commit_frame();
+	}
+
+	// GPU time of each viewport's render pass and, optionally, of each ImDrawList in it, from timestamp queries. Results are
+	// read back when the renderer reuses the frame slot that wrote them, a few frames later, so reading never stalls.
+	// Only the GLFW/Vulkan renderer records spans, on devices with host query reset (Vulkan 1.2 or
+	// VK_EXT_host_query_reset), which software ICDs such as lavapipe have.
+	namespace gpu_timing
+	{
+		struct span
+		{
+			char	 m_name[48]	   = {};	// "viewport" for the render pass, otherwise the owner of the draw list
+			uint32_t m_viewport_id = 0;		// ImGuiViewport::ID
+			int		 m_depth	   = 0;		// 0 for the render pass, 1 for a draw list inside it
+			double	 m_start_ms	   = 0.0;	// on the GPU clock, since the first span recorded
+			double	 m_end_ms	   = 0.0;
+		};
+
+		static constexpr int history_size = 4096;
+
+		// Off by default, takes effect with the next recorded frame. per_draw_list adds a span around the draws of each
+		// ImDrawList; a draw that merges several lists counts towards the first of them.
+		void set_enabled(bool enabled, bool per_draw_list = false);
+		bool enabled();
+		bool per_draw_list();
+
+		// Spans read back during the last committed frame. Safe to call from any thread.
+		int	   last_frame(span* spans, int max_count);
+		double last_frame_ms(); // the render passes among them, summed
+
+		// The last history_size spans as Chrome trace event JSON, for chrome://tracing or Perfetto, one track per viewport
+		void write_chrome_trace(std::FILE* out);
+
+		// Instrumentation, from any thread. Start and end are in milliseconds on the GPU clock.
+		void add(const span& s);
+
+		// Copies name into s.m_name, cut short on a UTF-8 code point boundary when it doesn't fit
+		void set_name(span& s, const char* name);
+	}
+
+	// Timeline of the last init() up to the end of the first end_frame(). Steps that ran concurrently overlap.
+	namespace startup
+	{
+		struct step
+		{
+			const char* m_name	   = nullptr;
+			double		m_start_ms = 0.0; // since init() was called
+			double		m_end_ms   = 0.0; // equal to m_start_ms while the step is still running
+			int			m_thread   = 0;	  // 0 is the thread that called init(), workers are numbered in order of first use
+		};
+
+		static constexpr int max_steps = 32;
+
+		// Copies the recorded steps in the order they started and returns how many were copied. Safe to call from any thread.
+		int query(step* steps, int max_count);
+
+		// From init() to the end of the first end_frame(), 0 until then
+		double time_to_first_frame_ms();
+
+		// One line per step, for logs
+		void print(std::FILE* out);
+	}
+}
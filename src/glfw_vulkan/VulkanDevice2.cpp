@@ -69,6 +69,16 @@ namespace FGC
 		return !!_deviceExtensions.count(name);
 	}
 
+	/*
+	=================================================
+		GetDeviceProcAddr
+	=================================================
+	*/
+	PFN_vkVoidFunction VulkanDevice2::GetDeviceProcAddr(NtStringView name) const
+	{
+		return _vkLogicalDevice ? vkGetDeviceProcAddr(_vkLogicalDevice, name.c_str()) : null;
+	}
+
 	/*
 	=================================================
 		SetObjectName
@@ -516,6 +526,9 @@ namespace FGC
 #ifdef VK_KHR_ray_tracing
 			VkPhysicalDeviceRayTracingFeaturesKHR rayTracing;
 #endif
+#ifdef VK_EXT_host_query_reset
+			VkPhysicalDeviceHostQueryResetFeaturesEXT hostQueryReset;
+#endif
 
 			DeviceFeatures()
 			{
@@ -545,6 +558,7 @@ namespace FGC
 			bool shaderClock : 1;
 			bool extendedDynamicState : 1;
 			bool rayTracing : 1;
+			bool hostQueryReset : 1;
 
 			EnabledExtensions()
 			{
@@ -715,6 +729,13 @@ namespace FGC
 					enabled.rayTracing = true;
 					continue;
 				}
+#endif
+#ifdef VK_EXT_host_query_reset
+				if (ext == VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME)
+				{
+					enabled.hostQueryReset = true;
+					continue;
+				}
 #endif
 			}
 
@@ -878,6 +899,14 @@ namespace FGC
 				features.rayTracing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_FEATURES_KHR;
 			}
 #endif
+#ifdef VK_EXT_host_query_reset
+			if (enabled.hostQueryReset or is_vk_1_2)
+			{
+				*next_feat = *nextExt = &features.hostQueryReset;
+				next_feat = nextExt			  = &features.hostQueryReset.pNext;
+				features.hostQueryReset.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES_EXT;
+			}
+#endif
 
 			*next_feat = *nextExt = &features.shaderDrawParameters;
 			next_feat = nextExt					= &features.shaderDrawParameters.pNext;
@@ -1169,6 +1198,9 @@ namespace FGC
 #ifdef VK_KHR_shader_atomic_int64
 		_features.shaderAtomicInt64 = _vkVersion >= InstanceVersion{1, 2} or HasDeviceExtension(VK_KHR_SHADER_ATOMIC_INT64_EXTENSION_NAME);
 #endif
+#ifdef VK_EXT_host_query_reset
+		_features.hostQueryReset = _vkVersion >= InstanceVersion{1, 2} or HasDeviceExtension(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME);
+#endif
 #ifdef VK_KHR_spirv_1_4
 		_features.spirv14 = _vkVersion >= InstanceVersion{1, 2} or HasDeviceExtension(VK_KHR_SPIRV_1_4_EXTENSION_NAME);
 #endif
@@ -1251,6 +1283,15 @@ namespace FGC
 				timeline_sem_feat.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
 			}
 #endif
+#ifdef VK_EXT_host_query_reset
+			VkPhysicalDeviceHostQueryResetFeaturesEXT host_query_reset_feat = {};
+			if (_features.hostQueryReset)
+			{
+				*next_feat					= &host_query_reset_feat;
+				next_feat					= &host_query_reset_feat.pNext;
+				host_query_reset_feat.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES_EXT;
+			}
+#endif
 #ifdef VK_KHR_buffer_device_address
 			if (_features.bufferAddress)
 			{
@@ -1330,6 +1371,9 @@ namespace FGC
 #ifdef VK_KHR_timeline_semaphore
 			_features.timelineSemaphore &= (timeline_sem_feat.timelineSemaphore == VK_TRUE);
 #endif
+#ifdef VK_EXT_host_query_reset
+			_features.hostQueryReset &= (host_query_reset_feat.hostQueryReset == VK_TRUE);
+#endif
 #ifdef VK_KHR_buffer_device_address
 			_features.bufferAddress &= (_properties.bufferDeviceAddress.bufferDeviceAddress == VK_TRUE);
 #endif
@@ -1487,7 +1531,8 @@ namespace FGC
 			<< "\n  shaderClock:              " << ToString(_features.shaderClock) << "\n  timelineSemaphore:        " << ToString(_features.timelineSemaphore)
 			<< "\n  pushDescriptor:           " << ToString(_features.pushDescriptor) << "\n  robustness2:              " << ToString(_features.robustness2)
 			<< "\n  shaderStencilExport:      " << ToString(_features.shaderStencilExport) << "\n  extendedDynamicState:     " << ToString(_features.extendedDynamicState)
-			<< "\n  rayTracing:               " << ToString(_features.rayTracing) << "\n  ----------");
+			<< "\n  rayTracing:               " << ToString(_features.rayTracing) << "\n  hostQueryReset:           " << ToString(_features.hostQueryReset)
+			<< "\n  ----------");
 
 		VulkanLoader::SetupDeviceBackwardCompatibility(_properties.properties.apiVersion, INOUT _deviceFnTable);
 		return true;
@@ -2511,6 +2556,9 @@ namespace FGC
 #ifdef VK_EXT_memory_budget
 			VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
 #endif
+#ifdef VK_EXT_host_query_reset
+			VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME,
+#endif
 #ifdef VK_KHR_shader_clock
 			VK_KHR_SHADER_CLOCK_EXTENSION_NAME,
 #endif
@@ -80,6 +80,7 @@ namespace FGC
 			bool spirv14 : 1;
 			bool memoryModel : 1; // to use GL_KHR_memory_scope_semantics, SPV_KHR_vulkan_memory_model
 			bool samplerFilterMinmax : 1;
+			bool hostQueryReset : 1; // vkResetQueryPool
 			// window extensions
 			bool surface : 1;
 			bool surfaceCaps2 : 1;
@@ -279,6 +280,9 @@ namespace FGC
 		ND_ bool HasInstanceExtension(StringView name) const;
 		ND_ bool HasDeviceExtension(StringView name) const;
 
+		// for entry points the function table doesn't load, null if the device doesn't expose it
+		ND_ PFN_vkVoidFunction GetDeviceProcAddr(NtStringView name) const;
+
 		bool SetObjectName(uint64_t id, NtStringView name, VkObjectType type) const;
 
 		void GetQueueFamilies(VQueueMask mask, OUT VQueueFamilyIndices_t&) const;
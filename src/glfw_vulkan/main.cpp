@@ -6,14 +6,41 @@
 #include <Framework/Vulkan/VulkanSwapchain.h>
 #include <framegraph/FG.h>
 #include <framegraph/Shared/EnumUtils.h>
+
+#if IMGUI_APP_RUNTIME_SHADER_COMPILER
 #include <pipeline_compiler/VPipelineCompiler.h>
+#include "imgui_shaders.h"
+#endif
+
+#if IMGUI_APP_PRECOMPILED_SHADERS
+#include "imgui_frag_bindless.spv.h"
+#include "imgui_frag_push.spv.h"
+#include "imgui_frag_uniform.spv.h"
+#include "imgui_vert_bindless.spv.h"
+#include "imgui_vert_push.spv.h"
+#include "imgui_vert_uniform.spv.h"
+#endif
 
 #include <imgui.h>
 #include <imgui_internal.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <future>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <GLFW/glfw3.h>
 #ifdef _WIN32
@@ -371,18 +398,356 @@ struct basis_cache
 	}
 };
 
+// ImDrawIdx is chosen when imgui is compiled, IMGUI_APP_32BIT_INDICES makes it 32-bit
+static_assert(sizeof(ImDrawIdx) == 2 || sizeof(ImDrawIdx) == 4, "ImDrawIdx must be 16 or 32-bit");
+static constexpr FG::EIndex imgui_index_type = sizeof(ImDrawIdx) == 4 ? FG::EIndex::UInt : FG::EIndex::UShort;
+
+// Entry of the compact draw list built by imgui_renderer::merge_draws(): a user callback, or one DrawIndexed covering a
+// run of adjacent ImDrawCmds
+struct imgui_merged_draw
+{
+	const ImDrawList* m_callback_list = nullptr;
+	const ImDrawCmd*  m_callback	  = nullptr;
+
+	ImTextureID	   m_texture = nullptr;
+	FG::uint	   m_texture_slot = 0; // resolved from m_texture by imgui_renderer::draw()
+	FG::RawImageID m_texture_image;
+	bool		   m_premultiplied = false; // resolved along with m_texture_slot
+	FG::RectI	   m_scissor;
+	FG::uint	m_first_index	= 0;
+	FG::uint	m_index_count	= 0;
+	int			m_vertex_offset = 0;
+	int			m_contained		= -1; // all geometry inside m_scissor: -1 not checked yet, 0 no, 1 yes
+	ImVec4		m_bounds;				  // framebuffer bounds of the run's vertices (min xy, max zw), valid once m_contained >= 0
+	int			m_first_list	= 0;
+	int			m_first_cmd		= 0;
+	bool		m_cached		= false; // geometry is read from the list cache instead of the frame's ring region
+};
+
+// First-fit allocator of element ranges in a buffer of fixed capacity, freed ranges coalesce with their neighbours
+struct range_allocator
+{
+	std::map<size_t, size_t> m_free; // offset to size
+
+	void reset(size_t capacity)
+	{
+		m_free.clear();
+		if (capacity > 0)
+		{
+			m_free.emplace(0, capacity);
+		}
+	}
+
+	bool allocate(size_t size, size_t& offset)
+	{
+		for (auto it = m_free.begin(); it != m_free.end(); ++it)
+		{
+			if (it->second >= size)
+			{
+				offset					= it->first;
+				const size_t remainder	= it->second - size;
+				m_free.erase(it);
+				if (remainder > 0)
+				{
+					m_free.emplace(offset + size, remainder);
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void release(size_t offset, size_t size)
+	{
+		auto next = m_free.lower_bound(offset);
+		if (next != m_free.end() and offset + size == next->first)
+		{
+			size += next->second;
+			next = m_free.erase(next);
+		}
+
+		if (next != m_free.begin())
+		{
+			auto previous = std::prev(next);
+			if (previous->first + previous->second == offset)
+			{
+				previous->second += size;
+				return;
+			}
+		}
+		m_free.emplace(offset, size);
+	}
+};
+
 struct imgui_renderer_window
 {
-	FG::BufferID m_vertex_buffer;
-	FG::BufferID m_index_buffer;
-	FG::BufferID m_uniform_buffer;
+	static constexpr size_t max_frames_in_flight = 8;
+
+	// Frame N+1 only waits for the frame that used the same slot m_frame_count frames earlier, so recording overlaps
+	// the GPU consuming the previous frames. Set from set_frames_in_flight() in init().
+	size_t m_frame_count = 3;
+	size_t m_frame_index = 0;
+
+	// Vertices and indices are written straight into one host-visible buffer that stays mapped, split into one region
+	// per frame in flight. A slot is rewritten once the command buffer that last read it has completed.
+	FG::BufferID	  m_geometry_buffer;
+	uint8_t*		  m_geometry_data		 = nullptr;
+	size_t			  m_geometry_region_size = 0;
+	size_t			  m_vertex_offset		 = 0;
+	size_t			  m_index_offset		 = 0;
+	FG::CommandBuffer m_frame_readers[max_frames_in_flight];
+
+	// A list whose geometry hashes the same as a list of the previous frame is copied once into a device-local buffer and
+	// drawn from there until it goes unused for cache_linger_frames, so static windows cost no geometry writes. Vertices
+	// fill the front of the buffer and indices the back. Lists that change every frame, and small ones whose draws are
+	// better merged with their neighbours in the ring, keep going through the ring.
+	static constexpr int	  min_cached_vertices = 256;
+	static constexpr uint64_t cache_linger_frames = 60;
+	static constexpr size_t	  max_cache_vertices  = size_t(4) << 20;
+
+	struct cached_list
+	{
+		size_t	 m_first_vertex = 0;
+		size_t	 m_vertex_count = 0;
+		size_t	 m_first_index	= 0;
+		size_t	 m_index_count	= 0;
+		uint64_t m_last_used	= 0; // m_frame_serial
+
+		// What was uploaded. A hit is only trusted when the list still matches, the geometry hash isn't collision-free
+		std::vector<ImDrawVert> m_vertices;
+		std::vector<ImDrawIdx>	m_indices;
+
+		bool holds(const ImDrawList& cmd_list) const
+		{
+			return m_vertices.size() == size_t(cmd_list.VtxBuffer.Size) and m_indices.size() == size_t(cmd_list.IdxBuffer.Size) and
+				   std::memcmp(m_vertices.data(), cmd_list.VtxBuffer.Data, m_vertices.size() * sizeof(ImDrawVert)) == 0 and
+				   std::memcmp(m_indices.data(), cmd_list.IdxBuffer.Data, m_indices.size() * sizeof(ImDrawIdx)) == 0;
+		}
+	};
+
+	// Where each list of the frame being recorded reads its geometry from, filled by imgui_renderer::place_lists()
+	struct list_placement
+	{
+		const cached_list* m_cached		 = nullptr; // null for the ring
+		bool			   m_upload		 = false;	// cached this frame, write_geometry() uploads it
+		FG::uint		   m_first_index = 0;		// of the list in its buffer
+		int				   m_vertex_base = 0;		// added to the list's indices
+	};
 
-	FG::BytesU m_vertex_buf_size;
-	FG::BytesU m_index_buf_size;
+	FG::BufferID							  m_cache_buffer;
+	size_t									  m_cache_vertex_capacity = 0; // in ImDrawVerts, indices get 3 times as many
+	size_t									  m_cache_index_offset	  = 0; // in bytes
+	bool									  m_cache_grow			  = false;
+	range_allocator							  m_cache_vertices;
+	range_allocator							  m_cache_indices;
+	std::unordered_map<uint64_t, cached_list> m_cached_lists;	// by hash_draw_list_geometry()
+	std::unordered_set<uint64_t>			  m_ring_hashes[2]; // of the lists written to the ring, the last frame first
+	std::vector<list_placement>				  m_placements;
+	size_t									  m_ring_vertex_count = 0;
+	size_t									  m_ring_index_count  = 0;
+	uint64_t								  m_frame_serial	  = 0;
+
+	FG::BufferID m_uniform_buffers[max_frames_in_flight]; // only without push constants
 
 	FG::PipelineResources m_resources;
+	uint32_t			  m_texture_generation = ~0u; // of the texture table bound into m_resources
+
+	std::vector<imgui_merged_draw> m_draws; // rebuilt every frame, kept for its capacity
+
+	// Draws into a cleared image that is later composited, see window_cache. Alpha is accumulated as coverage so the image
+	// ends up premultiplied.
+	bool m_offscreen = false;
+};
+
+// Timestamp queries around a viewport's render pass and, with gpu_timing::per_draw_list(), around each draw list in it.
+// Each frame slot owns a range of one query pool. The range is read back and reset from the host once acquire_frame()
+// has waited for the slot, so results are always ready and recording never stalls on them. The timestamps are written
+// by CustomDraw tasks, which run in the order they were added to the pass.
+struct gpu_timer
+{
+	static constexpr uint32_t max_lists			= 63;
+	static constexpr uint32_t queries_per_frame = 2 * (max_lists + 1);
+
+	struct frame
+	{
+		uint32_t												  m_query_count = 0; // written by the frame last recorded in the slot
+		std::array<imgui_app_fw::gpu_timing::span, max_lists + 1> m_spans;			 // names and depths, pass first
+	};
+
+	const FGC::VulkanDevice2* m_device		   = nullptr;
+	PFN_vkResetQueryPoolEXT	  m_reset_query_pool = nullptr;
+	VkQueryPool				  m_pool			 = VK_NULL_HANDLE;
+	double					  m_period_ns		 = 1.0;
+	bool					  m_unsupported		 = false;
+	bool					  m_active			 = false; // timing the frame being recorded
+	frame*					  m_frame			 = nullptr;
+	int						  m_list			 = -1; // draw list with an open span
+
+	std::array<frame, imgui_renderer_window::max_frames_in_flight> m_frames;
+
+	bool create(const FGC::VulkanDevice2& device)
+	{
+		const VkPhysicalDeviceLimits& limits = device.GetProperties().properties.limits;
+		if (!device.GetFeatures().hostQueryReset or !limits.timestampComputeAndGraphics or limits.timestampPeriod <= 0.0f)
+		{
+			return false;
+		}
+
+		m_reset_query_pool = reinterpret_cast<PFN_vkResetQueryPoolEXT>(device.GetDeviceProcAddr("vkResetQueryPool"));
+		if (!m_reset_query_pool)
+		{
+			m_reset_query_pool = reinterpret_cast<PFN_vkResetQueryPoolEXT>(device.GetDeviceProcAddr("vkResetQueryPoolEXT"));
+		}
+		CHECK_ERR(m_reset_query_pool);
+
+		VkQueryPoolCreateInfo info = {};
+		info.sType				   = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		info.queryType			   = VK_QUERY_TYPE_TIMESTAMP;
+		info.queryCount			   = queries_per_frame * uint32_t(m_frames.size());
+		VK_CHECK(device.vkCreateQueryPool(device.GetVkDevice(), &info, nullptr, OUT & m_pool));
+
+		m_reset_query_pool(device.GetVkDevice(), m_pool, 0, info.queryCount);
+		m_device	= &device;
+		m_period_ns = double(limits.timestampPeriod);
+		return true;
+	}
+
+	// The GPU must be done with every frame that wrote queries
+	void destroy()
+	{
+		if (m_pool != VK_NULL_HANDLE)
+		{
+			m_device->vkDestroyQueryPool(m_device->GetVkDevice(), m_pool, nullptr);
+			m_pool = VK_NULL_HANDLE;
+		}
+		for (frame& f : m_frames)
+		{
+			f.m_query_count = 0;
+		}
+	}
+
+	// After acquire_frame() waited for the slot: hands what the slot measured last time to gpu_timing, then starts timing
+	// the frame being recorded into it if timing is on
+	void begin_frame(const FGC::VulkanDevice2& device, size_t slot, uint32_t viewport_id)
+	{
+		m_active = false;
+		if (m_pool == VK_NULL_HANDLE)
+		{
+			if (m_unsupported or !imgui_app_fw::gpu_timing::enabled())
+			{
+				return;
+			}
+			if (!create(device))
+			{
+				m_unsupported = true;
+				return;
+			}
+		}
+
+		m_frame				   = &m_frames[slot];
+		const uint32_t first   = queries_per_frame * uint32_t(slot);
+		const uint32_t written = m_frame->m_query_count;
+		if (written > 0)
+		{
+			std::array<uint64_t, queries_per_frame> ticks;
+			if (m_device->vkGetQueryPoolResults(m_device->GetVkDevice(), m_pool, first, written, sizeof(ticks), ticks.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+			{
+				for (uint32_t i = 0; i + 1 < written; i += 2)
+				{
+					imgui_app_fw::gpu_timing::span& span = m_frame->m_spans[i / 2];
+					span.m_start_ms						 = double(ticks[i]) * m_period_ns * 1.0e-6;
+					span.m_end_ms						 = double(ticks[i + 1]) * m_period_ns * 1.0e-6;
+					imgui_app_fw::gpu_timing::add(span);
+				}
+			}
+			m_reset_query_pool(m_device->GetVkDevice(), m_pool, first, written);
+			m_frame->m_query_count = 0;
+		}
+
+		if (imgui_app_fw::gpu_timing::enabled())
+		{
+			m_active = true;
+			m_list	 = -1;
+			for (imgui_app_fw::gpu_timing::span& span : m_frame->m_spans)
+			{
+				span.m_viewport_id = viewport_id;
+			}
+		}
+	}
+
+	// Spans are written as start and end query pairs; the pass span is the first pair
+	void begin_pass(const FG::CommandBuffer& cmdbuf, FG::LogicalPassID pass_id)
+	{
+		if (m_active)
+		{
+			imgui_app_fw::gpu_timing::span& span = m_frame->m_spans[0];
+			imgui_app_fw::gpu_timing::set_name(span, "viewport");
+			span.m_depth = 0;
+			write(cmdbuf, pass_id, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+			// the end of the pass goes into query 1, lists start at 2
+			++m_frame->m_query_count;
+		}
+	}
+
+	void end_pass(const FG::CommandBuffer& cmdbuf, FG::LogicalPassID pass_id)
+	{
+		if (m_active)
+		{
+			end_list(cmdbuf, pass_id);
+			write_at(cmdbuf, pass_id, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 1);
+			m_active = false;
+		}
+	}
+
+	// Closes the span of the previous list, if any, and opens one for list, while queries last
+	void begin_list(const FG::CommandBuffer& cmdbuf, FG::LogicalPassID pass_id, int list, const ImDrawList& cmd_list)
+	{
+		if (!m_active or !imgui_app_fw::gpu_timing::per_draw_list() or list == m_list)
+		{
+			return;
+		}
+
+		end_list(cmdbuf, pass_id);
+		if (m_frame->m_query_count + 2 > queries_per_frame)
+		{
+			return;
+		}
 
-	std::map<ImTextureID, FG::ImageID> m_texture_cache;
+		imgui_app_fw::gpu_timing::span& span = m_frame->m_spans[m_frame->m_query_count / 2];
+		imgui_app_fw::gpu_timing::set_name(span, cmd_list._OwnerName ? cmd_list._OwnerName : "draw list");
+		span.m_depth = 1;
+		write(cmdbuf, pass_id, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+		m_list = list;
+	}
+
+	void end_list(const FG::CommandBuffer& cmdbuf, FG::LogicalPassID pass_id)
+	{
+		if (m_list >= 0)
+		{
+			write(cmdbuf, pass_id, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+			m_list = -1;
+		}
+	}
+
+	void write(const FG::CommandBuffer& cmdbuf, FG::LogicalPassID pass_id, VkPipelineStageFlagBits stage)
+	{
+		write_at(cmdbuf, pass_id, stage, m_frame->m_query_count++);
+	}
+
+	void write_at(const FG::CommandBuffer& cmdbuf, FG::LogicalPassID pass_id, VkPipelineStageFlagBits stage, uint32_t index)
+	{
+		const FGC::VulkanDevice2* device = m_device;
+		const VkQueryPool		  pool	 = m_pool;
+		const uint32_t			  query	 = queries_per_frame * uint32_t(m_frame - m_frames.data()) + index;
+
+		cmdbuf->AddTask(pass_id, FG::CustomDraw{[device, pool, query, stage](void*, FG::IDrawContext& ctx) {
+			auto data = ctx.GetData();
+			if (auto* vk = std::get_if<FG::VulkanContext>(&data))
+			{
+				device->vkCmdWriteTimestamp(FGC::BitCast<VkCommandBuffer>(vk->commandBuffer), stage, pool, query);
+			}
+		}, nullptr});
+	}
 };
 
 struct imgui_renderer
@@ -391,22 +756,87 @@ struct imgui_renderer
 	FG::SamplerID	m_font_sampler;
 	FG::GPipelineID m_pipeline;
 
-	bool init_shared(ImGuiContext* _context, const FG::FrameGraph& fg)
+	// Of the atlas in m_font_texture, see update_font_texture()
+	int					  m_font_width = 0;
+	std::vector<uint64_t> m_font_row_hashes;
+
+	// The viewport transform goes in push constants, so it needs no buffer, upload or task dependency. The uniform
+	// buffer path remains for when the push constant pipeline can't be created.
+	bool m_push_constants = true;
+
+	// With descriptor indexing every window binds the whole texture table once and each draw passes its slot in the push
+	// constants, so draws of different textures share one descriptor set. Otherwise each draw binds its own texture.
+	bool m_bindless = false;
+
+	static constexpr FG::uint max_textures = 256;
+
+	// An ImTextureID is a slot of this table. Slot 0, the null ImTextureID, is the font atlas; so are free and unknown slots.
+	std::mutex					m_texture_mutex;
+	std::vector<FG::RawImageID> m_textures = std::vector<FG::RawImageID>(1);
+	std::vector<uint8_t>		m_premultiplied = std::vector<uint8_t>(1); // per slot, drawn with premultiplied alpha blending
+	uint32_t					m_texture_generation = 0;
+
+	// Matches uPushConstant of the bindless pipeline
+	struct bindless_push_constants
 	{
-		CHECK_ERR(create_pipeline(fg));
-		CHECK_ERR(create_sampler(fg));
+		FG::float4 m_transform;
+		FG::uint   m_texture;
+	};
 
-		// initialize font atlas
+	bool init_shared(const FG::FrameGraph& fg, bool descriptor_indexing)
+	{
+		m_bindless		 = descriptor_indexing and create_pipeline(fg, true, true);
+		m_push_constants = m_bindless or create_pipeline(fg, true, false);
+		if (!m_push_constants)
 		{
-			uint8_t* pixels;
-			int		 width, height;
-			_context->IO.Fonts->GetTexDataAsRGBA32(OUT & pixels, OUT & width, OUT & height);
+			CHECK_ERR(create_pipeline(fg, false, false));
 		}
+		CHECK_ERR(create_sampler(fg));
 		return true;
 	}
 
-	bool init(imgui_renderer_window& pw, ImGuiContext* _context, const FG::FrameGraph& fg)
+	ImTextureID register_texture(FG::RawImageID image, bool premultiplied = false)
+	{
+		std::lock_guard<std::mutex> lock(m_texture_mutex);
+
+		size_t slot = 1;
+		while (slot < m_textures.size() and m_textures[slot] != FG::RawImageID{})
+		{
+			++slot;
+		}
+
+		if (slot == m_textures.size())
+		{
+			if (slot == max_textures)
+			{
+				return nullptr;
+			}
+			m_textures.emplace_back();
+			m_premultiplied.emplace_back();
+		}
+
+		m_textures[slot]	  = image;
+		m_premultiplied[slot] = premultiplied;
+		++m_texture_generation;
+		return reinterpret_cast<ImTextureID>(uintptr_t(slot));
+	}
+
+	void unregister_texture(ImTextureID texture)
+	{
+		std::lock_guard<std::mutex> lock(m_texture_mutex);
+
+		const uintptr_t slot = reinterpret_cast<uintptr_t>(texture);
+		if (slot != 0 and slot < m_textures.size())
+		{
+			m_textures[slot]	  = FG::RawImageID{};
+			m_premultiplied[slot] = false;
+			++m_texture_generation;
+		}
+	}
+
+	bool init(imgui_renderer_window& pw, const FG::FrameGraph& fg)
 	{
+		pw.m_frame_count = std::clamp<size_t>(size_t(imgui_app_fw::frames_in_flight_requested()), 1, imgui_renderer_window::max_frames_in_flight);
 		CHECK_ERR(init_pipeline(pw, fg));
 		return true;
 	}
@@ -415,9 +845,25 @@ struct imgui_renderer
 	{
 		if (fg)
 		{
-			fg->ReleaseResource(INOUT pw.m_vertex_buffer);
-			fg->ReleaseResource(INOUT pw.m_index_buffer);
-			fg->ReleaseResource(INOUT pw.m_uniform_buffer);
+			fg->ReleaseResource(INOUT pw.m_geometry_buffer);
+			fg->ReleaseResource(INOUT pw.m_cache_buffer);
+			for (FG::BufferID& uniform_buffer : pw.m_uniform_buffers)
+			{
+				fg->ReleaseResource(INOUT uniform_buffer);
+			}
+		}
+
+		pw.m_geometry_data		  = nullptr;
+		pw.m_geometry_region_size = 0;
+		pw.m_cache_vertex_capacity = 0;
+		pw.m_cached_lists.clear();
+		for (std::unordered_set<uint64_t>& hashes : pw.m_ring_hashes)
+		{
+			hashes.clear();
+		}
+		for (FG::CommandBuffer& reader : pw.m_frame_readers)
+		{
+			reader = FG::CommandBuffer{};
 		}
 	}
 
@@ -429,11 +875,14 @@ struct imgui_renderer
 			fg->ReleaseResource(INOUT m_font_sampler);
 			fg->ReleaseResource(INOUT m_pipeline);
 		}
+		m_font_width = 0;
+		m_font_row_hashes.clear();
 	}
 
+	// timer is null for draws that aren't timed, such as window cache redraws
 	template<typename T_USERDRAW_HANDLER>
 	FG::Task draw(
-		imgui_renderer_window& pw, ImDrawData* draw_data, ImGuiContext* _context, const FG::CommandBuffer& cmdbuf, FG::LogicalPassID pass_id, FG::ArrayView<FG::Task> dependencies,
+		imgui_renderer_window& pw, gpu_timer* timer, ImDrawData* draw_data, ImGuiContext* _context, const FG::CommandBuffer& cmdbuf, FG::LogicalPassID pass_id, FG::ArrayView<FG::Task> dependencies,
 		T_USERDRAW_HANDLER userdraw_handler = [](const ImDrawList& cmd_list, const ImDrawCmd& cmd) -> FG::Task { return nullptr; })
 	{
 		CHECK_ERR(cmdbuf and _context);
@@ -450,8 +899,13 @@ struct imgui_renderer
 
 		FG::SubmitRenderPass submit{pass_id};
 
-		submit.DependsOn(create_buffers(pw, draw_data, _context, cmdbuf));
-		submit.DependsOn(update_uniform_buffer(pw, draw_data, _context, cmdbuf));
+		write_geometry(pw, draw_data, cmdbuf, submit);
+		const FG::float4 transform = viewport_transform(draw_data);
+		if (!m_push_constants)
+		{
+			submit.DependsOn(update_uniform_buffer(pw, transform, cmdbuf));
+			pw.m_resources.BindBuffer(FG::UniformID("uPushConstant"), pw.m_uniform_buffers[pw.m_frame_index]);
+		}
 
 		for (auto dep : dependencies)
 		{
@@ -464,496 +918,2045 @@ struct imgui_renderer
 		vert_input.Add(FG::VertexID("aUV"), FG::EVertexType::Float2, FG::OffsetOf(&ImDrawVert::uv));
 		vert_input.Add(FG::VertexID("aColor"), FG::EVertexType::UByte4_Norm, FG::OffsetOf(&ImDrawVert::col));
 
-		FG::uint idx_offset = 0;
-		FG::uint vtx_offset = 0;
-
-		ImVec2 clip_off	  = draw_data->DisplayPos;		 // (0,0) unless using multi-viewports
-		ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
+		const int command_count = merge_draws(pw, draw_data, fb_width, fb_height);
+		int		  draw_count	= 0;
 
-		pw.m_resources.BindBuffer(FG::UniformID("uPushConstant"), pw.m_uniform_buffer);
+		if (timer)
+		{
+			timer->begin_pass(cmdbuf, pass_id);
+		}
 
-		for (int i = 0; i < draw_data->CmdListsCount; ++i)
+		// Resolved up front, callbacks below may register textures
 		{
-			const ImDrawList& cmd_list = *draw_data->CmdLists[i];
+			std::lock_guard<std::mutex> lock(m_texture_mutex);
 
-			for (int j = 0; j < cmd_list.CmdBuffer.Size; ++j)
+			if (m_bindless and pw.m_texture_generation != m_texture_generation)
 			{
-				const ImDrawCmd& cmd = cmd_list.CmdBuffer[j];
-
-				if (cmd.UserCallback)
-				{
-					if (cmd.UserCallback == ImDrawCallback_ResetRenderState)
-					{
-						// state is bound to the draw tasks, so this isn't needed?
-					}
-					else
-					{
-						submit.DependsOn(userdraw_handler(cmd_list, cmd));
-					}
-				}
-				else
+				// A redraw pass renders into one of the premultiplied window cache images, which must not also be bound
+				// for sampling in the same pass; the window's own lists never draw them
+				for (FG::uint slot = 0; slot < max_textures; ++slot)
 				{
-					FG::RectI scissor;
-					scissor.left   = int((cmd.ClipRect.x - clip_off.x) * clip_scale.x);
-					scissor.top	   = int((cmd.ClipRect.y - clip_off.y) * clip_scale.y);
-					scissor.right  = int((cmd.ClipRect.z - clip_off.x) * clip_scale.x);
-					scissor.bottom = int((cmd.ClipRect.w - clip_off.y) * clip_scale.y);
-
-					if (scissor.left < fb_width && scissor.top < fb_height && scissor.right >= 0.0f && scissor.bottom >= 0.0f)
-					{
-						// Negative offsets are illegal for vkCmdSetScissor
-						if (scissor.left < 0)
-						{
-							scissor.left = 0;
-						}
-
-						if (scissor.top < 0)
-						{
-							scissor.top = 0;
-						}
-
-						if (cmd.TextureId)
-						{
-							// pw.m_resources.BindTexture(FG::UniformID("sTexture"), static_cast<FG::RawImageID>(cmd.TextureId), m_font_sampler);
-							pw.m_resources.BindTexture(FG::UniformID("sTexture"), m_font_texture, m_font_sampler);
-						}
-						else
-						{
-							pw.m_resources.BindTexture(FG::UniformID("sTexture"), m_font_texture, m_font_sampler);
-						}
-
-						cmdbuf->AddTask(
-							pass_id, FG::DrawIndexed{}
-										 .SetPipeline(m_pipeline)
-										 .AddResources(FG::DescriptorSetID{"0"}, pw.m_resources)
-										 .AddVertexBuffer(FG::VertexBufferID(), pw.m_vertex_buffer)
-										 .SetVertexInput(vert_input)
-										 .SetTopology(FG::EPrimitive::TriangleList)
-										 .SetIndexBuffer(pw.m_index_buffer, (FG::BytesU)0, FG::EIndex::UShort)
-										 .AddColorBuffer(FG::RenderTargetID::Color_0, FG::EBlendFactor::SrcAlpha, FG::EBlendFactor::OneMinusSrcAlpha, FG::EBlendOp::Add)
-										 .SetDepthTestEnabled(false)
-										 .SetCullMode(FG::ECullMode::None)
-										 .Draw(cmd.ElemCount, 1, idx_offset, int(vtx_offset), 0)
-										 .AddScissor(scissor));
-					}
+					const bool cache_image = pw.m_offscreen and slot < m_premultiplied.size() and m_premultiplied[slot];
+					pw.m_resources.BindTexture(FG::UniformID("sTextures"), texture_image(cache_image ? 0 : slot), m_font_sampler, slot);
 				}
-				idx_offset += cmd.ElemCount;
+				pw.m_texture_generation = m_texture_generation;
 			}
 
-			vtx_offset += cmd_list.VtxBuffer.Size;
+			for (imgui_merged_draw& draw : pw.m_draws)
+			{
+				draw.m_texture_slot	 = texture_slot(draw.m_texture);
+				draw.m_texture_image = texture_image(draw.m_texture_slot);
+				draw.m_premultiplied = m_premultiplied[draw.m_texture_slot] != 0;
+			}
 		}
 
-		return cmdbuf->AddTask(submit);
-	}
-
-	bool create_pipeline(const FG::FrameGraph& fg)
-	{
-		using namespace std::string_literals;
-
-		FG::GraphicsPipelineDesc desc;
-
-		desc.AddShader(FG::EShader::Vertex, FG::EShaderLangFormat::VKSL_100, "main", R"#(
-			#version 450 core
-			layout(location = 0) in vec2 aPos;
-			layout(location = 1) in vec2 aUV;
-			layout(location = 2) in vec4 aColor;
+		for (const imgui_merged_draw& draw : pw.m_draws)
+		{
+			if (timer)
+			{
+				timer->begin_list(cmdbuf, pass_id, draw.m_first_list, *draw_data->CmdLists[draw.m_first_list]);
+			}
 
-			//layout(push_constant) uniform uPushConstant {
-			layout(set=0, binding=1, std140) uniform uPushConstant {
-				vec2 uScale;
-				vec2 uTranslate;
-			} pc;
+			if (draw.m_callback)
+			{
+				submit.DependsOn(userdraw_handler(*draw.m_callback_list, *draw.m_callback));
+				continue;
+			}
 
-			out gl_PerVertex{
-				vec4 gl_Position;
-			};
+			if (!m_bindless)
+			{
+				pw.m_resources.BindTexture(FG::UniformID("sTexture"), draw.m_texture_image, m_font_sampler);
+			}
 
-			layout(location = 0) out struct{
-				vec4 Color;
-				vec2 UV;
-			} Out;
+			FG::DrawIndexed task;
+			if (draw.m_cached)
+			{
+				task.AddVertexBuffer(FG::VertexBufferID(), pw.m_cache_buffer, FG::BytesU{0})
+					.SetIndexBuffer(pw.m_cache_buffer, FG::BytesU{pw.m_cache_index_offset}, imgui_index_type);
+			}
+			else
+			{
+				task.AddVertexBuffer(FG::VertexBufferID(), pw.m_geometry_buffer, FG::BytesU{pw.m_vertex_offset})
+					.SetIndexBuffer(pw.m_geometry_buffer, FG::BytesU{pw.m_index_offset}, imgui_index_type);
+			}
 
-			void main()
+			if (pw.m_offscreen)
+			{
+				task.AddColorBuffer(FG::RenderTargetID::Color_0, FG::EBlendFactor::SrcAlpha, FG::EBlendFactor::One, FG::EBlendFactor::OneMinusSrcAlpha,
+					FG::EBlendFactor::OneMinusSrcAlpha, FG::EBlendOp::Add, FG::EBlendOp::Add);
+			}
+			else if (draw.m_premultiplied)
 			{
-				Out.Color = aColor;
-				Out.UV = aUV;
-				gl_Position = vec4(aPos*pc.uScale+pc.uTranslate, 0, 1);
-			})#"s);
+				task.AddColorBuffer(FG::RenderTargetID::Color_0, FG::EBlendFactor::One, FG::EBlendFactor::OneMinusSrcAlpha, FG::EBlendOp::Add);
+			}
+			else
+			{
+				task.AddColorBuffer(FG::RenderTargetID::Color_0, FG::EBlendFactor::SrcAlpha, FG::EBlendFactor::OneMinusSrcAlpha, FG::EBlendOp::Add);
+			}
 
-		desc.AddShader(FG::EShader::Fragment, FG::EShaderLangFormat::VKSL_100, "main", R"#(
-			#version 450 core
-			layout(location = 0) out vec4 out_Color0;
+			task.SetPipeline(m_pipeline)
+				.AddResources(FG::DescriptorSetID{"0"}, pw.m_resources)
+				.SetVertexInput(vert_input)
+				.SetTopology(FG::EPrimitive::TriangleList)
+				.SetDepthTestEnabled(false)
+				.SetCullMode(FG::ECullMode::None)
+				.Draw(draw.m_index_count, 1, draw.m_first_index, draw.m_vertex_offset, 0)
+				.AddScissor(draw.m_scissor);
 
-			layout(set=0, binding=0) uniform sampler2D sTexture;
+			if (m_bindless)
+			{
+				task.AddPushConstant(FG::PushConstantID("uPushConstant"), bindless_push_constants{transform, draw.m_texture_slot});
+			}
+			else if (m_push_constants)
+			{
+				task.AddPushConstant(FG::PushConstantID("uPushConstant"), transform);
+			}
 
-			layout(location = 0) in struct{
-				vec4 Color;
-				vec2 UV;
-			} In;
+			cmdbuf->AddTask(pass_id, task);
+			++draw_count;
+		}
 
-			void main()
-			{
-				out_Color0 = In.Color * texture(sTexture, In.UV.st);
-			})#"s);
+		if (timer)
+		{
+			timer->end_pass(cmdbuf, pass_id);
+		}
+		imgui_app_fw::frame_stats::add_draws(command_count, draw_count);
 
-		m_pipeline = fg->CreatePipeline(desc);
-		CHECK_ERR(m_pipeline);
-		return true;
+		return cmdbuf->AddTask(submit);
 	}
 
-	bool init_pipeline(imgui_renderer_window& pw, const FG::FrameGraph& fg)
+	// Slot of a registered ImTextureID, 0 for the font atlas and anything unknown. Call with m_texture_mutex locked.
+	FG::uint texture_slot(ImTextureID texture) const
 	{
-		CHECK_ERR(fg->InitPipelineResources(m_pipeline, FG::DescriptorSetID("0"), OUT pw.m_resources));
-		return true;
+		const uintptr_t slot = reinterpret_cast<uintptr_t>(texture);
+		return slot < m_textures.size() and m_textures[slot] != FG::RawImageID{} ? FG::uint(slot) : 0;
 	}
 
-	bool create_sampler(const FG::FrameGraph& fg)
+	// Call with m_texture_mutex locked
+	FG::RawImageID texture_image(FG::uint slot) const
 	{
-		FG::SamplerDesc desc;
-		desc.SetFilter(FG::EFilter::Linear, FG::EFilter::Linear, FG::EMipmapFilter::Linear);
-		desc.SetAddressMode(FG::EAddressMode::Repeat);
-		desc.SetLodRange(-1000.0f, 1000.0f);
-
-		m_font_sampler = fg->CreateSampler(desc);
-		CHECK_ERR(m_font_sampler);
-		return true;
+		if (slot != 0 and slot < m_textures.size() and m_textures[slot] != FG::RawImageID{})
+		{
+			return m_textures[slot];
+		}
+		return m_font_texture;
 	}
 
-	ND_ FG::Task create_font_texture(ImGuiContext* _context, const FG::CommandBuffer& cmdbuf)
+	// Shaders come from src/glfw_vulkan/shaders. Precompiled SPIR-V is preferred, it skips glslang at startup.
+	bool create_pipeline(const FG::FrameGraph& fg, bool push_constants, bool bindless)
 	{
-		if (m_font_texture)
+#if IMGUI_APP_PRECOMPILED_SHADERS
+		if (create_precompiled_pipeline(fg, push_constants, bindless))
 		{
-			return null;
+			return true;
 		}
+#endif
 
-		uint8_t* pixels;
-		int		 width, height;
-
-		_context->IO.Fonts->GetTexDataAsRGBA32(OUT & pixels, OUT & width, OUT & height);
+#if IMGUI_APP_RUNTIME_SHADER_COMPILER
+		const std::string defines = "#define PUSH_CONSTANTS " + std::to_string(push_constants ? 1 : 0) + "\n#define BINDLESS " + std::to_string(bindless ? 1 : 0) +
+									"\n#define MAX_TEXTURES " + std::to_string(max_textures) + "\n";
 
-		size_t upload_size = width * height * 4 * sizeof(char);
+		// Right after #version, which must come first
+		const auto with_defines = [&defines](std::string source) {
+			source.insert(source.find('\n') + 1, defines);
+			return source;
+		};
 
-		m_font_texture = cmdbuf->GetFrameGraph()->CreateImage(
-			FG::ImageDesc{}
-				.SetDimension({FG::uint(width), FG::uint(height)})
-				.SetFormat(FG::EPixelFormat::RGBA8_UNorm)
-				.SetUsage(FG::EImageUsage::Sampled | FG::EImageUsage::TransferDst),
-			FG::Default, "UI.FontTexture");
-		CHECK_ERR(m_font_texture);
+		FG::GraphicsPipelineDesc desc;
+		desc.AddShader(FG::EShader::Vertex, FG::EShaderLangFormat::VKSL_100, "main", with_defines(imgui_vertex_glsl));
+		desc.AddShader(FG::EShader::Fragment, FG::EShaderLangFormat::VKSL_100, "main", with_defines(imgui_fragment_glsl));
 
-		return cmdbuf->AddTask(FG::UpdateImage{}.SetImage(m_font_texture).SetData(pixels, upload_size, FG::uint2{FG::int2{width, height}}));
-	}
+		m_pipeline = fg->CreatePipeline(desc);
+		return bool(m_pipeline);
+#else
+		return false;
+#endif
+	}
+
+#if IMGUI_APP_PRECOMPILED_SHADERS
+	static_assert(max_textures == 256, "must match imgui_app_fw_max_textures in CMakeLists.txt");
+
+	// VPipelineCompiler reflects the layout from GLSL, a SPIR-V pipeline has to spell it out
+	bool create_precompiled_pipeline(const FG::FrameGraph& fg, bool push_constants, bool bindless)
+	{
+		using desc_t = FG::GraphicsPipelineDesc;
+
+		const auto words = [](const auto& spirv) { return FG::Array<FG::uint>(std::begin(spirv), std::end(spirv)); };
+
+		desc_t desc;
+		if (bindless)
+		{
+			desc.AddShader(FG::EShader::Vertex, FG::EShaderLangFormat::SPIRV_100, "main", words(imgui_vert_bindless_spirv));
+			desc.AddShader(FG::EShader::Fragment, FG::EShaderLangFormat::SPIRV_100, "main", words(imgui_frag_bindless_spirv));
+		}
+		else if (push_constants)
+		{
+			desc.AddShader(FG::EShader::Vertex, FG::EShaderLangFormat::SPIRV_100, "main", words(imgui_vert_push_spirv));
+			desc.AddShader(FG::EShader::Fragment, FG::EShaderLangFormat::SPIRV_100, "main", words(imgui_frag_push_spirv));
+		}
+		else
+		{
+			desc.AddShader(FG::EShader::Vertex, FG::EShaderLangFormat::SPIRV_100, "main", words(imgui_vert_uniform_spirv));
+			desc.AddShader(FG::EShader::Fragment, FG::EShaderLangFormat::SPIRV_100, "main", words(imgui_frag_uniform_spirv));
+		}
+
+		desc.SetVertexAttribs({{FG::VertexID("aPos"), 0, FG::EVertexType::Float2}, {FG::VertexID("aUV"), 1, FG::EVertexType::Float2}, {FG::VertexID("aColor"), 2, FG::EVertexType::Float4}});
+		desc.SetFragmentOutputs({{FG::RenderTargetID::Color_0, 0, FG::EFragOutput::Float4}});
+		desc.SetTopology(desc_t::TopologyBits_t{}.set(FG::uint(FG::EPrimitive::TriangleList)));
+
+		const desc_t::_TextureUniform texture{FG::UniformID(bindless ? "sTextures" : "sTexture"), FG::EImageSampler::Float2D, FG::BindingIndex{0, 0}, bindless ? max_textures : 1, FG::EShaderStages::Fragment};
+
+		FG::Array<desc_t::_UBufferUniform> uniform_buffers;
+		if (!push_constants)
+		{
+			uniform_buffers.push_back({FG::UniformID("uPushConstant"), FG::BytesU{sizeof(FG::float4)}, FG::BindingIndex{1, 1}, 1, FG::EShaderStages::Vertex});
+		}
+
+		desc.AddDescriptorSet(FG::DescriptorSetID("0"), 0, {texture}, {}, {}, {}, uniform_buffers, {});
+
+		if (push_constants)
+		{
+			const FG::BytesU size{bindless ? sizeof(bindless_push_constants) : sizeof(FG::float4)};
+			desc.SetPushConstants({{FG::PushConstantID("uPushConstant"), FG::EShaderStages::Vertex, FG::BytesU{0}, size}});
+		}
+
+		m_pipeline = fg->CreatePipeline(desc);
+		return bool(m_pipeline);
+	}
+#endif
+
+	bool init_pipeline(imgui_renderer_window& pw, const FG::FrameGraph& fg)
+	{
+		CHECK_ERR(fg->InitPipelineResources(m_pipeline, FG::DescriptorSetID("0"), OUT pw.m_resources));
+		return true;
+	}
+
+	bool create_sampler(const FG::FrameGraph& fg)
+	{
+		FG::SamplerDesc desc;
+		desc.SetFilter(FG::EFilter::Linear, FG::EFilter::Linear, FG::EMipmapFilter::Linear);
+		desc.SetAddressMode(FG::EAddressMode::Repeat);
+		desc.SetLodRange(-1000.0f, 1000.0f);
+
+		m_font_sampler = fg->CreateSampler(desc);
+		CHECK_ERR(m_font_sampler);
+		return true;
+	}
+
+	// Cheap hash of one row of atlas pixels, only compared with the same row of the previous upload
+	static uint64_t hash_font_row(const uint8_t* row, size_t size)
+	{
+		uint64_t hash = 0x9E3779B97F4A7C15ull ^ size;
+		size_t	 i	  = 0;
+		for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+		{
+			uint64_t word;
+			std::memcpy(&word, row + i, sizeof(word));
+			hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+			hash ^= hash >> 32;
+		}
+		for (; i < size; ++i)
+		{
+			hash = (hash ^ row[i]) * 0x100000001B3ull;
+		}
+		return hash;
+	}
+
+	// Uploads the RGBA32 pixels of atlas. The texture is created, or replaced when a rebuild changed the atlas size;
+	// otherwise only the bands of rows whose hash changed since the previous upload are written. Call with the font atlas
+	// locked. Returns the last upload, which draws depend on, or null when nothing changed.
+	ND_ FG::Task update_font_texture(ImFontAtlas* atlas, const FG::CommandBuffer& cmdbuf)
+	{
+		uint8_t* pixels;
+		int		 width, height;
+
+		atlas->GetTexDataAsRGBA32(OUT & pixels, OUT & width, OUT & height);
+
+		const size_t		  row_size = size_t(width) * 4;
+		std::vector<uint64_t> row_hashes(size_t(height));
+		for (int y = 0; y < height; ++y)
+		{
+			row_hashes[y] = hash_font_row(pixels + y * row_size, row_size);
+		}
+
+		const bool recreate = !m_font_texture or m_font_width != width or m_font_row_hashes.size() != row_hashes.size();
+		if (recreate)
+		{
+			auto fg = cmdbuf->GetFrameGraph();
+
+			// frames still in flight keep the old image alive until they complete
+			if (m_font_texture)
+			{
+				fg->ReleaseResource(INOUT m_font_texture);
+			}
+
+			m_font_texture = fg->CreateImage(
+				FG::ImageDesc{}
+					.SetDimension({FG::uint(width), FG::uint(height)})
+					.SetFormat(FG::EPixelFormat::RGBA8_UNorm)
+					.SetUsage(FG::EImageUsage::Sampled | FG::EImageUsage::TransferDst),
+				FG::Default, "UI.FontTexture");
+			CHECK_ERR(m_font_texture);
+			m_font_width = width;
+
+			std::lock_guard<std::mutex> lock(m_texture_mutex);
+			++m_texture_generation;
+		}
+
+		// Clean gaps shorter than this are uploaded along with the dirty rows around them, to keep the number of tasks down
+		constexpr int merge_gap = 8;
+
+		const auto dirty = [&](int y) { return recreate or row_hashes[y] != m_font_row_hashes[y]; };
+
+		FG::Task task;
+		for (int y = 0; y < height;)
+		{
+			if (!dirty(y))
+			{
+				++y;
+				continue;
+			}
+
+			int end = y + 1;
+			for (int next = end; next < height and next < end + merge_gap; ++next)
+			{
+				if (dirty(next))
+				{
+					end = next + 1;
+				}
+			}
+
+			const FG::uint rows = FG::uint(end - y);
+			task				= cmdbuf->AddTask(FG::UpdateImage{}
+										  .SetImage(m_font_texture, FG::int2{0, y})
+										  .SetData(pixels + y * row_size, rows * row_size, FG::uint2{FG::uint(width), rows})
+										  .DependsOn(task));
+			y = end;
+		}
+
+		m_font_row_hashes = std::move(row_hashes);
+		return task;
+	}
+
+	// Blocks until the GPU has finished every frame recorded for pw. Call with the queue locked.
+	bool wait_frames(imgui_renderer_window& pw, const FG::FrameGraph& fg)
+	{
+		for (FG::CommandBuffer& reader : pw.m_frame_readers)
+		{
+			if (reader)
+			{
+				CHECK_ERR(fg->Wait(FGC::ArrayView<FG::CommandBuffer>{&reader, 1}));
+				reader = FG::CommandBuffer{};
+			}
+		}
+		return true;
+	}
+
+	// Creates the list cache, or replaces it with one twice as large after place_lists() ran out of room. The lists in it
+	// are dropped and cached again when next seen. Call with the queue locked.
+	bool reserve_list_cache(imgui_renderer_window& pw, const FG::FrameGraph& fg)
+	{
+		if (!imgui_app_fw::geometry_cache_enabled() or (pw.m_cache_buffer and !pw.m_cache_grow))
+		{
+			return true;
+		}
+
+		size_t capacity = 64 * 1024;
+		if (pw.m_cache_buffer)
+		{
+			pw.m_cache_grow = false;
+			if (pw.m_cache_vertex_capacity >= imgui_renderer_window::max_cache_vertices)
+			{
+				return true;
+			}
+			capacity = pw.m_cache_vertex_capacity * 2;
+
+			CHECK_ERR(wait_frames(pw, fg));
+			fg->ReleaseResource(INOUT pw.m_cache_buffer);
+			pw.m_cached_lists.clear();
+		}
+
+		const size_t index_offset = (capacity * sizeof(ImDrawVert) + 3) & ~size_t(3);
+		const size_t buffer_size  = index_offset + capacity * 3 * sizeof(ImDrawIdx);
+		pw.m_cache_buffer		  = fg->CreateBuffer(
+			  FG::BufferDesc{FG::BytesU{buffer_size}, FG::EBufferUsage::Vertex | FG::EBufferUsage::Index | FG::EBufferUsage::TransferDst}, FG::Default, "UI.ListCache");
+		CHECK_ERR(pw.m_cache_buffer);
+
+		pw.m_cache_vertex_capacity = capacity;
+		pw.m_cache_index_offset	   = index_offset;
+		pw.m_cache_vertices.reset(capacity);
+		pw.m_cache_indices.reset(capacity * 3);
+		return true;
+	}
+
+	// Reserves room in the cache for cmd_list, end() when there is none, in which case the cache grows next frame
+	std::unordered_map<uint64_t, imgui_renderer_window::cached_list>::iterator cache_list(imgui_renderer_window& pw, uint64_t hash, const ImDrawList& cmd_list)
+	{
+		imgui_renderer_window::cached_list entry;
+		entry.m_vertex_count = size_t(cmd_list.VtxBuffer.Size);
+		entry.m_index_count	 = size_t(cmd_list.IdxBuffer.Size);
+
+		if (pw.m_cache_vertices.allocate(entry.m_vertex_count, entry.m_first_vertex))
+		{
+			if (pw.m_cache_indices.allocate(entry.m_index_count, entry.m_first_index))
+			{
+				entry.m_vertices.assign(cmd_list.VtxBuffer.begin(), cmd_list.VtxBuffer.end());
+				entry.m_indices.assign(cmd_list.IdxBuffer.begin(), cmd_list.IdxBuffer.end());
+				return pw.m_cached_lists.emplace(hash, std::move(entry)).first;
+			}
+			pw.m_cache_vertices.release(entry.m_first_vertex, entry.m_vertex_count);
+		}
+
+		pw.m_cache_grow = true;
+		return pw.m_cached_lists.end();
+	}
+
+	// Fills pw.m_placements: a list already in the cache is drawn from it, one that hashes the same as a list written to
+	// the ring last frame is cached now, and the rest go to the ring. Then drops cached lists unused for
+	// cache_linger_frames, which is more than the frames in flight, so the GPU is done with them.
+	void place_lists(imgui_renderer_window& pw, const ImDrawData* draw_data)
+	{
+		const bool use_cache = imgui_app_fw::geometry_cache_enabled() and pw.m_cache_buffer;
+
+		const std::unordered_set<uint64_t>& previous_hashes = pw.m_ring_hashes[0];
+		std::unordered_set<uint64_t>&		current_hashes	= pw.m_ring_hashes[1];
+		current_hashes.clear();
+
+		pw.m_placements.resize(size_t(draw_data->CmdListsCount));
+		pw.m_ring_vertex_count = 0;
+		pw.m_ring_index_count  = 0;
+
+		for (int i = 0; i < draw_data->CmdListsCount; ++i)
+		{
+			const ImDrawList&					   cmd_list	 = *draw_data->CmdLists[i];
+			imgui_renderer_window::list_placement& placement = pw.m_placements[i];
+			placement										 = {};
+
+			if (use_cache and cmd_list.VtxBuffer.Size >= imgui_renderer_window::min_cached_vertices)
+			{
+				const uint64_t hash = imgui_app_fw::hash_draw_list_geometry(cmd_list);
+
+				auto it = pw.m_cached_lists.find(hash);
+				if (it == pw.m_cached_lists.end() and previous_hashes.count(hash) != 0)
+				{
+					it				   = cache_list(pw, hash, cmd_list);
+					placement.m_upload = it != pw.m_cached_lists.end();
+				}
+
+				// A different list with the same hash goes through the ring, the entry stays for the list it holds
+				if (it != pw.m_cached_lists.end() and (placement.m_upload or it->second.holds(cmd_list)))
+				{
+					it->second.m_last_used	= pw.m_frame_serial;
+					placement.m_cached		= &it->second;
+					placement.m_first_index = FG::uint(it->second.m_first_index);
+					placement.m_vertex_base = int(it->second.m_first_vertex);
+					continue;
+				}
+
+				current_hashes.insert(hash);
+			}
+
+			// write_geometry() zeroes the vertex base when indices are rebased onto the start of the region
+			placement.m_first_index = FG::uint(pw.m_ring_index_count);
+			placement.m_vertex_base = int(pw.m_ring_vertex_count);
+			pw.m_ring_vertex_count += size_t(cmd_list.VtxBuffer.Size);
+			pw.m_ring_index_count += size_t(cmd_list.IdxBuffer.Size);
+		}
+
+		std::swap(pw.m_ring_hashes[0], pw.m_ring_hashes[1]);
+
+		for (auto it = pw.m_cached_lists.begin(); it != pw.m_cached_lists.end();)
+		{
+			const imgui_renderer_window::cached_list& entry = it->second;
+			if (entry.m_last_used + imgui_renderer_window::cache_linger_frames <= pw.m_frame_serial)
+			{
+				pw.m_cache_vertices.release(entry.m_first_vertex, entry.m_vertex_count);
+				pw.m_cache_indices.release(entry.m_first_index, entry.m_index_count);
+				it = pw.m_cached_lists.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	// Moves to the next frame slot and waits for the command buffer that last used it, which was recorded m_frame_count
+	// frames ago and has normally completed, so the wait rarely blocks. Places the lists of draw_data and grows the
+	// geometry ring when the ones it gets don't fit its region. Call with the queue locked.
+	bool acquire_frame(imgui_renderer_window& pw, const ImDrawData* draw_data, const FG::FrameGraph& fg)
+	{
+		const auto align = [](size_t value, size_t alignment) { return (value + alignment - 1) & ~(alignment - 1); };
+
+		pw.m_frame_index = (pw.m_frame_index + 1) % pw.m_frame_count;
+		++pw.m_frame_serial;
+
+		FG::CommandBuffer& reader = pw.m_frame_readers[pw.m_frame_index];
+		if (reader)
+		{
+			CHECK_ERR(fg->Wait(FGC::ArrayView<FG::CommandBuffer>{&reader, 1}));
+			reader = FG::CommandBuffer{};
+		}
+
+		CHECK_ERR(reserve_list_cache(pw, fg));
+		place_lists(pw, draw_data);
+
+		const size_t vertex_size = pw.m_ring_vertex_count * sizeof(ImDrawVert);
+		const size_t index_size	 = pw.m_ring_index_count * sizeof(ImDrawIdx);
+		const size_t region_size = align(align(vertex_size, 4) + index_size, 256);
+
+		if (not pw.m_geometry_buffer or region_size > pw.m_geometry_region_size)
+		{
+			// Every region moves, so all slots must be idle. Half again the requested size keeps a UI that grows a little
+			// each frame from landing here every frame.
+			CHECK_ERR(wait_frames(pw, fg));
+
+			fg->ReleaseResource(INOUT pw.m_geometry_buffer);
+			pw.m_geometry_data		  = nullptr;
+			pw.m_geometry_region_size = 0;
+
+			const size_t new_region_size = align(std::max<size_t>(region_size + region_size / 2, 64 * 1024), 256);
+			const size_t capacity		 = new_region_size * pw.m_frame_count;
+			pw.m_geometry_buffer		 = fg->CreateBuffer(
+				FG::BufferDesc{FG::BytesU{capacity}, FG::EBufferUsage::Vertex | FG::EBufferUsage::Index}, FG::MemoryDesc{FG::EMemoryType::HostWrite}, "UI.GeometryRing");
+			CHECK_ERR(pw.m_geometry_buffer);
+
+			FG::BytesU mapped_size{capacity};
+			void*	   mapped = nullptr;
+			CHECK_ERR(fg->MapBufferRange(pw.m_geometry_buffer, (FG::BytesU)0, INOUT mapped_size, OUT mapped));
+			CHECK_ERR(mapped_size == FG::BytesU{capacity});
+
+			pw.m_geometry_data		  = static_cast<uint8_t*>(mapped);
+			pw.m_geometry_region_size = new_region_size;
+		}
+
+		pw.m_vertex_offset = pw.m_frame_index * pw.m_geometry_region_size;
+		pw.m_index_offset  = pw.m_vertex_offset + align(vertex_size, 4);
+		return true;
+	}
+
+	// Copies the lists placed in the ring into the region picked by acquire_frame(); no transfer task is needed. When those
+	// fit the index type together, their indices are rebased onto the first vertex of the region so draws can merge across
+	// lists. Lists cached this frame are uploaded by one transfer task that submit waits for.
+	void write_geometry(imgui_renderer_window& pw, const ImDrawData* draw_data, const FG::CommandBuffer& cmdbuf, FG::SubmitRenderPass& submit)
+	{
+		ASSERT(pw.m_geometry_data);
+
+		const bool shared_base = pw.m_ring_vertex_count <= size_t(std::numeric_limits<ImDrawIdx>::max()) + 1;
+
+		uint8_t*   vtx_dst	= pw.m_geometry_data + pw.m_vertex_offset;
+		ImDrawIdx* idx_dst	= reinterpret_cast<ImDrawIdx*>(pw.m_geometry_data + pw.m_index_offset);
+		ImDrawIdx  vtx_base = 0;
+
+		FG::UpdateBuffer upload;
+		upload.SetBuffer(pw.m_cache_buffer);
+		bool	uploading = false;
+		int64_t written	  = 0;
+		int64_t reused	  = 0;
+
+		for (int i = 0; i < draw_data->CmdListsCount; ++i)
+		{
+			const ImDrawList&					   cmd_list	 = *draw_data->CmdLists[i];
+			imgui_renderer_window::list_placement& placement = pw.m_placements[i];
+			const int64_t						   size		 = cmd_list.VtxBuffer.size_in_bytes() + cmd_list.IdxBuffer.size_in_bytes();
+
+			if (placement.m_cached)
+			{
+				if (placement.m_upload)
+				{
+					upload.AddData(cmd_list.VtxBuffer.Data, size_t(cmd_list.VtxBuffer.Size), FG::BytesU{placement.m_cached->m_first_vertex * sizeof(ImDrawVert)});
+					upload.AddData(cmd_list.IdxBuffer.Data, size_t(cmd_list.IdxBuffer.Size), FG::BytesU{pw.m_cache_index_offset + placement.m_cached->m_first_index * sizeof(ImDrawIdx)});
+					uploading = true;
+					written += size;
+				}
+				else
+				{
+					reused += size;
+				}
+				continue;
+			}
+
+			std::memcpy(vtx_dst, cmd_list.VtxBuffer.Data, cmd_list.VtxBuffer.size_in_bytes());
+			vtx_dst += cmd_list.VtxBuffer.size_in_bytes();
+
+			if (shared_base)
+			{
+				placement.m_vertex_base = 0;
+			}
+
+			if (shared_base and vtx_base != 0)
+			{
+				for (const ImDrawIdx idx : cmd_list.IdxBuffer)
+				{
+					*idx_dst++ = ImDrawIdx(idx + vtx_base);
+				}
+			}
+			else
+			{
+				std::memcpy(idx_dst, cmd_list.IdxBuffer.Data, cmd_list.IdxBuffer.size_in_bytes());
+				idx_dst += cmd_list.IdxBuffer.Size;
+			}
+
+			vtx_base = ImDrawIdx(vtx_base + cmd_list.VtxBuffer.Size);
+			written += size;
+		}
+
+		if (uploading)
+		{
+			submit.DependsOn(cmdbuf->AddTask(upload));
+		}
+
+		imgui_app_fw::frame_stats::add_geometry(written, reused);
+		pw.m_frame_readers[pw.m_frame_index] = cmdbuf;
+	}
+
+	// Framebuffer bounds of the vertices cmd references: min in xy, max in zw
+	static ImVec4 vertex_bounds(const ImDrawList& cmd_list, const ImDrawCmd& cmd, ImVec2 clip_off, ImVec2 clip_scale)
+	{
+		const ImDrawIdx*  idx = cmd_list.IdxBuffer.Data + cmd.IdxOffset;
+		const ImDrawVert* vtx = cmd_list.VtxBuffer.Data + cmd.VtxOffset;
+
+		ImVec2 min{FLT_MAX, FLT_MAX};
+		ImVec2 max{-FLT_MAX, -FLT_MAX};
+		for (unsigned int i = 0; i < cmd.ElemCount; ++i)
+		{
+			const ImVec2 pos = vtx[idx[i]].pos;
+			min.x			 = std::min(min.x, pos.x);
+			min.y			 = std::min(min.y, pos.y);
+			max.x			 = std::max(max.x, pos.x);
+			max.y			 = std::max(max.y, pos.y);
+		}
+		return ImVec4((min.x - clip_off.x) * clip_scale.x, (min.y - clip_off.y) * clip_scale.y, (max.x - clip_off.x) * clip_scale.x, (max.y - clip_off.y) * clip_scale.y);
+	}
+
+	// True when bounds lie inside scissor, so a larger scissor would change no pixel of the geometry
+	static bool inside_scissor(const ImVec4& bounds, const FG::RectI& scissor)
+	{
+		return bounds.x >= float(scissor.left) and bounds.z <= float(scissor.right) and bounds.y >= float(scissor.top) and bounds.w <= float(scissor.bottom);
+	}
+
+	static void add_bounds(ImVec4& bounds, const ImVec4& other)
+	{
+		bounds.x = std::min(bounds.x, other.x);
+		bounds.y = std::min(bounds.y, other.y);
+		bounds.z = std::max(bounds.z, other.z);
+		bounds.w = std::max(bounds.w, other.w);
+	}
+
+	// Builds pw.m_draws in submission order. An ImDrawCmd joins the run before it when both draw the same texture from
+	// touching index ranges of the same buffer with the same vertex base, and either their scissors match or the geometry of both lies
+	// inside its own scissor, in which case the run takes the union of the two. There is a single pipeline, so it never
+	// splits a run. Callbacks and culled commands end a run. Returns the number of ImDrawCmds that draw.
+	int merge_draws(imgui_renderer_window& pw, const ImDrawData* draw_data, int fb_width, int fb_height)
+	{
+		const ImVec2 clip_off	= draw_data->DisplayPos;	   // (0,0) unless using multi-viewports
+		const ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
+
+		const auto same_rect = [](const FG::RectI& a, const FG::RectI& b) {
+			return a.left == b.left and a.top == b.top and a.right == b.right and a.bottom == b.bottom;
+		};
+
+		// Bounds of every command of the run, walked once when the run is first tested for a union. From then on they are
+		// extended command by command, so no command's indices are read twice
+		const auto run_bounds = [&](const imgui_merged_draw& run, int list_end, int cmd_end) {
+			ImVec4 bounds{FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX};
+			for (int i = run.m_first_list; i <= list_end; ++i)
+			{
+				const ImDrawList& cmd_list = *draw_data->CmdLists[i];
+				const int		  first	   = i == run.m_first_list ? run.m_first_cmd : 0;
+				const int		  last	   = i == list_end ? cmd_end : cmd_list.CmdBuffer.Size;
+
+				for (int j = first; j < last; ++j)
+				{
+					const ImDrawCmd& cmd = cmd_list.CmdBuffer[j];
+					if (!cmd.UserCallback and cmd.ElemCount != 0)
+					{
+						add_bounds(bounds, vertex_bounds(cmd_list, cmd, clip_off, clip_scale));
+					}
+				}
+			}
+			return bounds;
+		};
+
+		pw.m_draws.clear();
+
+		int	   command_count = 0;
+		size_t run			 = std::numeric_limits<size_t>::max();
+
+		for (int i = 0; i < draw_data->CmdListsCount; ++i)
+		{
+			const ImDrawList&							 cmd_list  = *draw_data->CmdLists[i];
+			const imgui_renderer_window::list_placement& placement = pw.m_placements[i];
+			const bool									 cached	   = placement.m_cached != nullptr;
+
+			for (int j = 0; j < cmd_list.CmdBuffer.Size; ++j)
+			{
+				const ImDrawCmd& cmd = cmd_list.CmdBuffer[j];
+
+				if (cmd.UserCallback)
+				{
+					// state is bound to the draw tasks, so ImDrawCallback_ResetRenderState isn't needed
+					if (cmd.UserCallback != ImDrawCallback_ResetRenderState)
+					{
+						imgui_merged_draw& callback = pw.m_draws.emplace_back();
+						callback.m_callback_list	= &cmd_list;
+						callback.m_callback			= &cmd;
+						callback.m_first_list		= i;
+						callback.m_first_cmd		= j;
+						run							= std::numeric_limits<size_t>::max();
+					}
+					continue;
+				}
+
+				if (cmd.ElemCount == 0)
+				{
+					continue;
+				}
+
+				++command_count;
+
+				FG::RectI scissor;
+				scissor.left   = int((cmd.ClipRect.x - clip_off.x) * clip_scale.x);
+				scissor.top	   = int((cmd.ClipRect.y - clip_off.y) * clip_scale.y);
+				scissor.right  = int((cmd.ClipRect.z - clip_off.x) * clip_scale.x);
+				scissor.bottom = int((cmd.ClipRect.w - clip_off.y) * clip_scale.y);
+
+				if (!(scissor.left < fb_width && scissor.top < fb_height && scissor.right >= 0.0f && scissor.bottom >= 0.0f))
+				{
+					run = std::numeric_limits<size_t>::max();
+					continue;
+				}
+
+				// Negative offsets are illegal for vkCmdSetScissor
+				scissor.left = std::max(scissor.left, 0);
+				scissor.top	 = std::max(scissor.top, 0);
+
+				const FG::uint first_index	 = placement.m_first_index + cmd.IdxOffset;
+				const int	   vertex_offset = placement.m_vertex_base + int(cmd.VtxOffset);
+				int			   contained	 = -1;
+				ImVec4		   bounds;
+
+				if (run < pw.m_draws.size())
+				{
+					imgui_merged_draw& r = pw.m_draws[run];
+
+					if (r.m_texture == cmd.TextureId and r.m_cached == cached and r.m_vertex_offset == vertex_offset and r.m_first_index + r.m_index_count == first_index)
+					{
+						if (same_rect(r.m_scissor, scissor))
+						{
+							// Clipped by the run's scissor itself, which a later union would loosen. A run found not contained
+							// stays so: its scissor only grows through unions, which need containment
+							if (r.m_contained > 0)
+							{
+								add_bounds(r.m_bounds, vertex_bounds(cmd_list, cmd, clip_off, clip_scale));
+								r.m_contained = inside_scissor(r.m_bounds, r.m_scissor) ? 1 : 0;
+							}
+							r.m_index_count += cmd.ElemCount;
+							continue;
+						}
+
+						if (r.m_contained < 0)
+						{
+							r.m_bounds	  = run_bounds(r, i, j);
+							r.m_contained = inside_scissor(r.m_bounds, r.m_scissor) ? 1 : 0;
+						}
+
+						if (r.m_contained)
+						{
+							bounds	  = vertex_bounds(cmd_list, cmd, clip_off, clip_scale);
+							contained = inside_scissor(bounds, scissor) ? 1 : 0;
+							if (contained)
+							{
+								r.m_scissor.left   = std::min(r.m_scissor.left, scissor.left);
+								r.m_scissor.top	   = std::min(r.m_scissor.top, scissor.top);
+								r.m_scissor.right  = std::max(r.m_scissor.right, scissor.right);
+								r.m_scissor.bottom = std::max(r.m_scissor.bottom, scissor.bottom);
+								add_bounds(r.m_bounds, bounds);
+								r.m_index_count += cmd.ElemCount;
+								continue;
+							}
+						}
+					}
+				}
+
+				imgui_merged_draw& draw = pw.m_draws.emplace_back();
+				draw.m_texture			= cmd.TextureId;
+				draw.m_scissor			= scissor;
+				draw.m_first_index		= first_index;
+				draw.m_index_count		= cmd.ElemCount;
+				draw.m_vertex_offset	= vertex_offset;
+				draw.m_contained		= contained;
+				draw.m_bounds			= bounds;
+				draw.m_first_list		= i;
+				draw.m_first_cmd		= j;
+				draw.m_cached			= cached;
+				run						= pw.m_draws.size() - 1;
+			}
+		}
+
+		return command_count;
+	}
+
+	// Maps ImGui coordinates of the viewport to clip space: scale in xy, translation in zw
+	static FG::float4 viewport_transform(const ImDrawData* draw_data)
+	{
+		FG::float4 pc_data;
+		// scale:
+		pc_data[0] = 2.0f / (draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+		pc_data[1] = 2.0f / (draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+		// transform:
+		pc_data[2] = -1.0f - draw_data->DisplayPos.x * pc_data[0];
+		pc_data[3] = -1.0f - draw_data->DisplayPos.y * pc_data[1];
+		return pc_data;
+	}
+
+	// Fallback when push constants are unavailable
+	ND_ FG::Task update_uniform_buffer(imgui_renderer_window& pw, const FG::float4& transform, const FG::CommandBuffer& cmdbuf)
+	{
+		FG::BufferID& uniform_buffer = pw.m_uniform_buffers[pw.m_frame_index];
+		if (not uniform_buffer)
+		{
+			uniform_buffer =
+				cmdbuf->GetFrameGraph()->CreateBuffer(FG::BufferDesc{(FG::BytesU)16, FG::EBufferUsage::Uniform | FG::EBufferUsage::TransferDst}, FG::Default, "UI.UniformBuffer");
+			CHECK_ERR(uniform_buffer);
+		}
+
+		return cmdbuf->AddTask(FG::UpdateBuffer{}.SetBuffer(uniform_buffer).AddData(&transform, 1));
+	}
+};
+
+struct platform_window_data
+{
+	GLFWwindow* m_window;
+	bool		m_window_owned;
+	int			m_ignore_window_pos_event_frame;
+	int			m_ignore_window_size_event_frame;
+
+	platform_window_data()
+	{
+		m_window						 = NULL;
+		m_window_owned					 = false;
+		m_ignore_window_size_event_frame = m_ignore_window_pos_event_frame = -1;
+	}
+
+	~platform_window_data()
+	{
+		IM_ASSERT(m_window == NULL);
+	}
+};
+
+struct platform_device_factory : public FGC::IVulkanSurface
+{
+	GLFWwindow* m_window;
+
+	platform_device_factory(GLFWwindow* wnd) : m_window{wnd} {}
+
+	virtual ~platform_device_factory() {}
+
+	FGC::ArrayView<const char*> GetRequiredExtensions() const override
+	{
+		uint32_t	 required_extension_count = 0;
+		const char** required_extensions	  = glfwGetRequiredInstanceExtensions(&required_extension_count);
+
+		return FGC::ArrayView<const char*>{required_extensions, required_extension_count};
+	}
+
+	SurfaceVk_t Create(InstanceVk_t inst) const override
+	{
+		VkSurfaceKHR surf = VK_NULL_HANDLE;
+		glfwCreateWindowSurface(FGC::BitCast<VkInstance>(inst), m_window, nullptr, &surf);
+		return FGC::BitCast<SurfaceVk_t>(surf);
+	}
+};
+
+struct platform_renderer_data
+{
+	bool m_is_primary{false};
+
+	FGC::VulkanDevice2::window_specific m_window_specific;
+	FG::SwapchainID						m_swapchain_id;
+	imgui_renderer_window				m_imgui_window;
+	gpu_timer							m_gpu_timer;
+	uint32_t							m_viewport_id = 0; // ImGuiViewport::ID, names the GPU timing spans
+
+	// Content of the last frame needs_render() let through, main thread only
+	uint64_t m_presented_hash	  = 0;
+	bool	 m_has_presented_hash = false;
+
+	// Set by the render thread when it drops a frame drawn with a font atlas that has since been rebuilt
+	std::atomic<bool> m_frame_dropped{false};
+
+	// Window size handle_resize() saw last, width in the high half and height in the low half, until the next frame of
+	// this viewport takes it with take_resize(); 0 when there is none. Main thread only.
+	uint64_t m_requested_size = 0;
+
+	// A window named with imgui_app_fw::cache_window(), drawn into an image of its own by composite_cached_windows() and
+	// shown as one textured quad. The image is allocated in steps of cache_image_step pixels so a window that grows a little
+	// doesn't recreate it; the window's pixels are at its top left. Geometry of the redraws goes through m_window, since
+	// the GPU may still be reading the viewport's ring.
+	static constexpr int	  cache_image_step	 = 128;
+	static constexpr uint64_t cache_linger_frames = 60;
+
+	struct window_cache
+	{
+		imgui_renderer_window m_window;
+		FG::ImageID			  m_image;
+		ImTextureID			  m_texture		 = nullptr;
+		int					  m_image_width	 = 0;
+		int					  m_image_height = 0;
+		int					  m_width		 = 0; // of the window, in pixels
+		int					  m_height		 = 0;
+		ImVec2				  m_scale;
+		uint64_t			  m_hash	  = 0; // hash_draw_list_at() of what the image holds
+		uint64_t			  m_last_used = 0; // m_composite_frame
+		bool				  m_valid	  = false;
+
+		ImDrawList* m_source = nullptr; // the window's list, while queued for a redraw
+		ImDrawData	m_draw_data;		// of m_source, positioned over the image
+		ImDrawList	m_quad{nullptr};
+	};
+
+	// By ImHashStr() of the window name. Like the viewport's other rendering state, only touched by whichever thread
+	// records its frames.
+	std::unordered_map<ImGuiID, std::unique_ptr<window_cache>> m_window_caches;
+	std::vector<window_cache*>								   m_redraws; // of the frame being recorded
+	ImVector<ImDrawList*>									   m_composited_lists;
+	ImDrawData												   m_composited;
+	uint64_t												   m_composite_frame = 0;
+
+	// Names passed to imgui_app_fw::cache_window(), by ImHashStr()
+	struct cached_window_names
+	{
+		std::mutex					m_mutex;
+		std::unordered_set<ImGuiID> m_ids;
+		std::atomic<bool>			m_any{false};
+
+		// Call with m_mutex locked. Child windows are named "Parent/Child_1234ABCD", so every part of the name before a
+		// '/' is looked up as well.
+		bool contains(const char* owner_name) const
+		{
+			if (!owner_name)
+			{
+				return false;
+			}
+
+			if (m_ids.count(ImHashStr(owner_name)) != 0)
+			{
+				return true;
+			}
+
+			for (const char* slash = std::strchr(owner_name, '/'); slash; slash = std::strchr(slash + 1, '/'))
+			{
+				if (m_ids.count(ImHashStr(owner_name, size_t(slash - owner_name))) != 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+	};
+
+	// One device, FrameGraph, pipeline, font atlas and font texture for every gui_primary_context in the process
+	struct shared_data
+	{
+		FGC::UniquePtr<FGC::VulkanDevice2Initializer> m_device;
+		FG::FrameGraph								  m_frame_graph;
+		imgui_renderer								  m_imgui_renderer;
+		FG::Array<FG::Task>							  m_shared_tasks;
+		std::unique_ptr<ImFontAtlas>				  m_font_atlas;
+		int											  m_users = 0;
+		std::mutex									  m_mutex;		 // guards everything above
+		std::mutex									  m_queue_mutex; // serializes Execute, Flush and WaitIdle across contexts
+		std::atomic<bool>							  m_flush_pending{false}; // something was executed since the last Flush
+
+		// Bumped by every build of m_font_atlas; load_assets() uploads when it differs from the generation in the texture.
+		// Uploads hold m_font_texture_mutex exclusively until executed, and a queued frame holds it shared from comparing
+		// its generation with the texture's until it is executed, so no upload lands in between.
+		std::atomic<uint32_t> m_font_generation{0};
+		std::shared_mutex	  m_font_texture_mutex;
+		uint32_t			  m_uploaded_font_generation = 0; // written under m_mutex and m_font_texture_mutex
+
+		cached_window_names m_cached_windows;
+	};
+
+	static inline shared_data m_shared;
+
+	// Held by each gui_primary_context from init() until it is destroyed. The font atlas is created for the first
+	// context, the device when its main viewport gets a renderer, and both are destroyed with the last context.
+	static ImFontAtlas* acquire_shared()
+	{
+		std::lock_guard<std::mutex> lock(m_shared.m_mutex);
+		if (m_shared.m_users++ == 0)
+		{
+			m_shared.m_font_atlas = std::make_unique<ImFontAtlas>();
+		}
+		return m_shared.m_font_atlas.get();
+	}
+
+	// Rasterizes the font atlas into the RGBA32 pixels update_font_texture() uploads, by the first context in init()
+	static void build_font_atlas()
+	{
+		std::lock_guard<std::mutex> lock(imgui_app_fw::fonts::atlas_mutex());
+		imgui_app_fw::fonts::update_atlas(m_shared.m_font_atlas.get());
+
+		uint8_t* pixels;
+		int		 width, height;
+		m_shared.m_font_atlas->GetTexDataAsRGBA32(OUT & pixels, OUT & width, OUT & height);
+		++m_shared.m_font_generation;
+	}
+
+	// Rebuilds the font atlas when glyphs were requested or fonts added since the last frame. Runs in begin_frame() with
+	// s_mutex held, so no context sharing the atlas is inside a frame.
+	static void update_font_atlas()
+	{
+		std::lock_guard<std::mutex> lock(imgui_app_fw::fonts::atlas_mutex());
+		if (imgui_app_fw::fonts::update_atlas(m_shared.m_font_atlas.get()))
+		{
+			uint8_t* pixels;
+			int		 width, height;
+			m_shared.m_font_atlas->GetTexDataAsRGBA32(OUT & pixels, OUT & width, OUT & height);
+			++m_shared.m_font_generation;
+		}
+	}
+
+	static uint32_t font_generation()
+	{
+		return m_shared.m_font_generation.load();
+	}
+
+	// Generation of the atlas in the font texture. Call with m_font_texture_mutex held.
+	static uint32_t uploaded_font_generation()
+	{
+		return m_shared.m_uploaded_font_generation;
+	}
+
+	static std::shared_mutex& font_texture_mutex()
+	{
+		return m_shared.m_font_texture_mutex;
+	}
+
+	static void release_shared()
+	{
+		std::lock_guard<std::mutex> lock(m_shared.m_mutex);
+		if (--m_shared.m_users > 0)
+		{
+			return;
+		}
+
+		if (m_shared.m_frame_graph)
+		{
+			m_shared.m_imgui_renderer.destroy_shared(m_shared.m_frame_graph);
+			m_shared.m_frame_graph->Deinitialize();
+			m_shared.m_frame_graph = nullptr;
+		}
+
+		if (m_shared.m_device)
+		{
+			m_shared.m_device->DestroyLogicalDevice();
+			m_shared.m_device->DestroyInstance();
+			m_shared.m_device.reset();
+		}
+
+		m_shared.m_shared_tasks.clear();
+		m_shared.m_flush_pending			= false;
+		m_shared.m_uploaded_font_generation = 0;
+		m_shared.m_font_atlas.reset();
+	}
+
+	// Creates the window's surface, and for the first context also the instance, device and FrameGraph, and compiles the
+	// pipeline. Touches neither ImGui nor GLFW state that isn't thread-safe, so the primary viewport runs it on a worker
+	// thread while the rest of startup proceeds.
+	bool create_device(GLFWwindow* window)
+	{
+		auto surface_factory = FGC::UniquePtr<FGC::IVulkanSurface>(new platform_device_factory(window));
+
+		std::lock_guard<std::mutex> lock(m_shared.m_mutex);
+		if (!m_shared.m_device)
+		{
+			imgui_app_fw::startup::scoped_step step("vulkan_device");
+
+			auto new_device			 = std::make_unique<FGC::VulkanDevice2Initializer>();
+			auto required_extensions = surface_factory->GetRequiredExtensions();
+			new_device->CreateInstance("app_name", "engine_name", new_device->GetRecomendedInstanceLayers(), required_extensions);
+
+			m_window_specific.CreateInstance(surface_factory, new_device->GetVkInstance());
+
+			new_device->ChooseHighPerformanceDevice();
+			new_device->CreateLogicalDevice({{VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_SPARSE_BINDING_BIT}, {VK_QUEUE_COMPUTE_BIT}, {VK_QUEUE_TRANSFER_BIT}}, true, true, FGC::Default);
+
+			FG::VulkanDeviceInfo vulkan_info;
+			{
+				vulkan_info.instance	   = FGC::BitCast<FG::InstanceVk_t>(new_device->GetVkInstance());
+				vulkan_info.physicalDevice = FGC::BitCast<FG::PhysicalDeviceVk_t>(new_device->GetVkPhysicalDevice());
+				vulkan_info.device		   = FGC::BitCast<FG::DeviceVk_t>(new_device->GetVkDevice());
+
+				vulkan_info.maxStagingBufferMemory = ~FGC::BytesU(0);
+				vulkan_info.stagingBufferSize	   = FGC::BytesU{8 * 1024 * 1024};
+
+				for (auto& q : new_device->GetVkQueues())
+				{
+					FG::VulkanDeviceInfo::QueueInfo qi;
+					qi.handle	   = FGC::BitCast<FG::QueueVk_t>(q.handle);
+					qi.familyFlags = FGC::BitCast<FG::QueueFlagsVk_t>(q.familyFlags);
+					qi.familyIndex = q.familyIndex;
+					qi.priority	   = q.priority;
+					qi.debugName   = q.debugName;
+
+					vulkan_info.queues.push_back(qi);
+				}
+			}
+			// FrameGraph creates its VkPipelineCache internally, empty, and VulkanDeviceInfo has no way to seed or read it, so
+			// pipeline creation can't be persisted across runs from here. IMGUI_APP_PRECOMPILED_SHADERS removes the glslang
+			// part of that cost for the UI pipeline.
+			m_shared.m_frame_graph = FG::IFrameGraph::CreateFrameGraph(vulkan_info);
+			CHECK_ERR(m_shared.m_frame_graph);
+
+#if IMGUI_APP_RUNTIME_SHADER_COMPILER
+			{
+				auto compiler = FG::MakeShared<FG::VPipelineCompiler>(vulkan_info.instance, vulkan_info.physicalDevice, vulkan_info.device);
+				compiler->SetCompilationFlags(FG::EShaderCompilationFlags::Quiet);
+				m_shared.m_frame_graph->AddPipelineCompiler(compiler);
+			}
+#endif
+
+			m_shared.m_device = std::move(new_device);
+
+			imgui_app_fw::startup::scoped_step pipeline_step("pipeline_compile");
+			const auto& limits				= m_shared.m_device->GetProperties().properties.limits;
+			bool		descriptor_indexing = m_shared.m_device->GetFeatures().descriptorIndexing and limits.maxPerStageDescriptorSamplers >= imgui_renderer::max_textures and
+									   limits.maxPerStageDescriptorSampledImages >= imgui_renderer::max_textures;
+#ifdef VK_EXT_descriptor_indexing
+			descriptor_indexing = descriptor_indexing and m_shared.m_device->GetProperties().descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing;
+#endif
+			CHECK_ERR(m_shared.m_imgui_renderer.init_shared(m_shared.m_frame_graph, descriptor_indexing));
+		}
+		else
+		{
+			m_window_specific.CreateInstance(surface_factory, m_shared.m_device->GetVkInstance());
+		}
+		return true;
+	}
+
+	// After create_device()
+	void init(ImGuiViewport* viewport, bool primary)
+	{
+		m_shared.m_imgui_renderer.init(m_imgui_window, m_shared.m_frame_graph);
+
+		m_swapchain_id			   = m_shared.m_frame_graph->CreateSwapchain(swapchain_create_info(uint32_t(viewport->Size.x), uint32_t(viewport->Size.y)));
+		m_is_primary			   = primary;
+		m_viewport_id			   = viewport->ID;
+		viewport->RendererUserData = this;
+	}
+
+	// Present mode and image count come from set_present_mode() and set_max_queued_frames()
+	FG::VulkanSwapchainCreateInfo swapchain_create_info(uint32_t width, uint32_t height)
+	{
+		VkPresentModeKHR mode = VK_PRESENT_MODE_FIFO_KHR;
+		switch (imgui_app_fw::present_mode_requested())
+		{
+		case imgui_app_fw::present_mode::fifo: mode = VK_PRESENT_MODE_FIFO_KHR; break;
+		case imgui_app_fw::present_mode::fifo_relaxed: mode = VK_PRESENT_MODE_FIFO_RELAXED_KHR; break;
+		case imgui_app_fw::present_mode::mailbox: mode = VK_PRESENT_MODE_MAILBOX_KHR; break;
+		case imgui_app_fw::present_mode::immediate: mode = VK_PRESENT_MODE_IMMEDIATE_KHR; break;
+		}
+
+		FG::VulkanSwapchainCreateInfo swapchain_info;
+		swapchain_info.surface		 = FGC::BitCast<FG::SurfaceVk_t>(m_window_specific.GetVkSurface());
+		swapchain_info.surfaceSize.x = width;
+		swapchain_info.surfaceSize.y = height;
+		swapchain_info.minImageCount = uint32_t(imgui_app_fw::max_queued_frames_requested()) + 1;
+
+		// the first supported entry wins
+		swapchain_info.presentModes.push_back(FGC::BitCast<FG::PresentModeVk_t>(mode));
+		if (mode != VK_PRESENT_MODE_FIFO_KHR)
+		{
+			swapchain_info.presentModes.push_back(FGC::BitCast<FG::PresentModeVk_t>(VK_PRESENT_MODE_FIFO_KHR));
+		}
+		return swapchain_info;
+	}
+
+	// Only records the new size. The swapchain is recreated by the next frame of this viewport, right before it is recorded,
+	// so a drag that resizes several times between two frames recreates it once and nothing waits for the render thread.
+	void handle_resize(ImGuiViewport* viewport)
+	{
+		auto window = (GLFWwindow*)viewport->PlatformHandle;
+		int	 new_width, new_height;
+		glfwGetWindowSize(window, &new_width, &new_height);
+
+		if (new_width > 0 && new_height > 0)
+		{
+			m_requested_size = (uint64_t(uint32_t(new_width)) << 32) | uint32_t(new_height);
+			invalidate_presented();
+		}
+	}
+
+	// Called on the main thread for the frame that will be recorded next, so frames queued before the resize still
+	// draw into the swapchain their draw data was laid out for
+	uint64_t take_resize()
+	{
+		return std::exchange(m_requested_size, 0);
+	}
+
+	// Recreates the swapchain at a size from take_resize(), passing the old one as oldSwapchain. Only this viewport's
+	// frames in flight are waited for before it is retired; other viewports and the rest of the queue keep running.
+	bool apply_resize(uint64_t size)
+	{
+		if (size == 0)
+		{
+			return true;
+		}
+
+		const FG::VulkanSwapchainCreateInfo swapchain_info = swapchain_create_info(uint32_t(size >> 32), uint32_t(size));
+
+		std::lock_guard<std::mutex> queue_lock(m_shared.m_queue_mutex);
+		CHECK_ERR(m_shared.m_imgui_renderer.wait_frames(m_imgui_window, m_shared.m_frame_graph));
+
+		m_swapchain_id = m_shared.m_frame_graph->CreateSwapchain(swapchain_info, m_swapchain_id.Release());
+		return true;
+	}
+
+	// False when draw_data is identical to the last frame this viewport rendered, which is then still on screen
+	bool needs_render(const ImDrawData* draw_data)
+	{
+		if (m_frame_dropped.exchange(false))
+		{
+			m_has_presented_hash = false;
+		}
+
+		uint64_t hash;
+		if (!imgui_app_fw::skip_unchanged_frames_enabled() || !imgui_app_fw::hash_draw_data(draw_data, hash))
+		{
+			m_has_presented_hash = false;
+			return true;
+		}
+
+		if (m_has_presented_hash && hash == m_presented_hash)
+		{
+			return false;
+		}
+
+		m_presented_hash	 = hash;
+		m_has_presented_hash = true;
+		return true;
+	}
+
+	void invalidate_presented()
+	{
+		m_has_presented_hash = false;
+	}
+
+	void destroy(ImGuiViewport* viewport)
+	{
+		if (m_gpu_timer.m_pool != VK_NULL_HANDLE)
+		{
+			std::lock_guard<std::mutex> lock(m_shared.m_queue_mutex);
+			m_shared.m_imgui_renderer.wait_frames(m_imgui_window, m_shared.m_frame_graph);
+			m_gpu_timer.destroy();
+		}
+
+		if (!m_window_caches.empty())
+		{
+			std::lock_guard<std::mutex> lock(m_shared.m_queue_mutex);
+			for (auto& entry : m_window_caches)
+			{
+				release_window_cache(*entry.second);
+			}
+			m_window_caches.clear();
+		}
+
+		m_shared.m_frame_graph->ReleaseResource(m_swapchain_id);
+		m_shared.m_imgui_renderer.destroy(m_imgui_window, m_shared.m_frame_graph);
+	}
+
+	void end_frame()
+	{
+		// Flush submits what every context executed, so whichever context gets here first does it
+		if (!m_shared.m_flush_pending.exchange(false))
+		{
+			return;
+		}
+
+		imgui_app_fw::frame_stats::scoped_phase timer(imgui_app_fw::frame_stats::phase::present);
+		std::lock_guard<std::mutex>				lock(m_shared.m_queue_mutex);
+		CHECK_ERR(m_shared.m_frame_graph->Flush());
+	}
+
+	FG::Task load_assets(ImGuiContext* ctx)
+	{
+		if (!m_is_primary)
+		{
+			return nullptr;
+		}
+
+		std::lock_guard<std::mutex> lock(m_shared.m_mutex);
+		if (m_shared.m_uploaded_font_generation != font_generation())
+		{
+			std::unique_lock<std::shared_mutex> texture_lock(m_shared.m_font_texture_mutex);
+			FG::CommandBuffer					cmdbuf = m_shared.m_frame_graph->Begin(FG::CommandBufferDesc{FG::EQueueType::Graphics});
+			m_shared.m_shared_tasks.clear();
+
+			FG::Task new_task;
+			{
+				std::lock_guard<std::mutex> font_lock(imgui_app_fw::fonts::atlas_mutex());
+				new_task							= m_shared.m_imgui_renderer.update_font_texture(m_shared.m_font_atlas.get(), cmdbuf);
+				m_shared.m_uploaded_font_generation = font_generation();
+			}
+
+			imgui_app_fw::frame_stats::scoped_phase timer(imgui_app_fw::frame_stats::phase::execute);
+			std::lock_guard<std::mutex>				queue_lock(m_shared.m_queue_mutex);
+			m_shared.m_frame_graph->Execute(cmdbuf);
+			m_shared.m_flush_pending = true;
+			return new_task;
+		}
+
+		return nullptr;
+	}
+
+	// Returns draw_data with the list of every cached window swapped for a quad showing its image, or draw_data itself when
+	// there are none. The windows whose list changed since their image was drawn are queued in m_redraws. A list is
+	// compared relative to the pixel its image starts at, so a window that only moved is not redrawn.
+	ImDrawData* composite_cached_windows(ImDrawData* draw_data)
+	{
+		cached_window_names& names = m_shared.m_cached_windows;
+
+		m_redraws.clear();
+		++m_composite_frame;
+		if (!names.m_any and m_window_caches.empty())
+		{
+			return draw_data;
+		}
+
+		bool composited = false;
+		m_composited_lists.resize(0);
+		{
+			std::lock_guard<std::mutex> lock(names.m_mutex);
+			for (int i = 0; i < draw_data->CmdListsCount; ++i)
+			{
+				ImDrawList*	  cmd_list = draw_data->CmdLists[i];
+				window_cache* cache	   = names.contains(cmd_list->_OwnerName) ? update_window_cache(*cmd_list, draw_data) : nullptr;
+				m_composited_lists.push_back(cache ? &cache->m_quad : cmd_list);
+				composited = composited or cache;
+			}
+		}
+
+		for (auto it = m_window_caches.begin(); it != m_window_caches.end();)
+		{
+			if (m_composite_frame - it->second->m_last_used > cache_linger_frames)
+			{
+				std::lock_guard<std::mutex> lock(m_shared.m_queue_mutex);
+				release_window_cache(*it->second);
+				it = m_window_caches.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		if (!composited)
+		{
+			return draw_data;
+		}
+
+		m_composited			   = *draw_data;
+		m_composited.CmdLists	   = m_composited_lists.Data;
+		m_composited.TotalVtxCount = 0;
+		m_composited.TotalIdxCount = 0;
+		for (const ImDrawList* cmd_list : m_composited_lists)
+		{
+			m_composited.TotalVtxCount += cmd_list->VtxBuffer.Size;
+			m_composited.TotalIdxCount += cmd_list->IdxBuffer.Size;
+		}
+		return &m_composited;
+	}
 
-	ND_ FG::Task create_buffers(imgui_renderer_window& pw, ImDrawData* draw_data, ImGuiContext* _context, const FG::CommandBuffer& cmdbuf)
+	// The cache of cmd_list with its quad set up for this frame, null when the list is drawn as usual: it has draw
+	// callbacks, lies outside the viewport, or no image or texture slot could be had
+	window_cache* update_window_cache(ImDrawList& cmd_list, const ImDrawData* draw_data)
 	{
-		FG::FrameGraph fg		   = cmdbuf->GetFrameGraph();
-		FG::BytesU	   vertex_size = draw_data->TotalVtxCount * FG::SizeOf<ImDrawVert>;
-		FG::BytesU	   index_size  = draw_data->TotalIdxCount * FG::SizeOf<ImDrawIdx>;
-
-		if (not pw.m_vertex_buffer or vertex_size > pw.m_vertex_buf_size)
+		if (cmd_list.VtxBuffer.Size == 0)
 		{
-			fg->ReleaseResource(INOUT pw.m_vertex_buffer);
-
-			pw.m_vertex_buf_size = vertex_size;
-			pw.m_vertex_buffer	 = fg->CreateBuffer(FG::BufferDesc{vertex_size, FG::EBufferUsage::TransferDst | FG::EBufferUsage::Vertex}, FG::Default, "UI.VertexBuffer");
+			return nullptr;
 		}
 
-		if (not pw.m_index_buffer or index_size > pw.m_index_buf_size)
-		{
-			fg->ReleaseResource(INOUT pw.m_index_buffer);
+		// Bounds of the vertices, within the clip rects and the viewport
+		const ImVec2 display_min = draw_data->DisplayPos;
+		const ImVec2 display_max{display_min.x + draw_data->DisplaySize.x, display_min.y + draw_data->DisplaySize.y};
+		const ImVec2 scale = draw_data->FramebufferScale;
 
-			pw.m_index_buf_size = index_size;
-			pw.m_index_buffer	= fg->CreateBuffer(FG::BufferDesc{index_size, FG::EBufferUsage::TransferDst | FG::EBufferUsage::Index}, FG::Default, "UI.IndexBuffer");
+		ImVec4 clip{FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX};
+		for (const ImDrawCmd& cmd : cmd_list.CmdBuffer)
+		{
+			if (cmd.UserCallback)
+			{
+				return nullptr;
+			}
+			clip = ImVec4(std::min(clip.x, cmd.ClipRect.x), std::min(clip.y, cmd.ClipRect.y), std::max(clip.z, cmd.ClipRect.z), std::max(clip.w, cmd.ClipRect.w));
 		}
 
-		FG::BytesU vb_offset;
-		FG::BytesU ib_offset;
+		ImVec2 min{FLT_MAX, FLT_MAX};
+		ImVec2 max{-FLT_MAX, -FLT_MAX};
+		for (const ImDrawVert& vertex : cmd_list.VtxBuffer)
+		{
+			min = ImVec2(std::min(min.x, vertex.pos.x), std::min(min.y, vertex.pos.y));
+			max = ImVec2(std::max(max.x, vertex.pos.x), std::max(max.y, vertex.pos.y));
+		}
+		min = ImVec2(std::max({min.x, clip.x, display_min.x}), std::max({min.y, clip.y, display_min.y}));
+		max = ImVec2(std::min({max.x, clip.z, display_max.x}), std::min({max.y, clip.w, display_max.y}));
+
+		// in framebuffer pixels, so the image lines up with them wherever the window is
+		const int left	 = int(std::floor((min.x - display_min.x) * scale.x));
+		const int top	 = int(std::floor((min.y - display_min.y) * scale.y));
+		const int width	 = int(std::ceil((max.x - display_min.x) * scale.x)) - left;
+		const int height = int(std::ceil((max.y - display_min.y) * scale.y)) - top;
+		if (width <= 0 or height <= 0)
+		{
+			return nullptr;
+		}
 
-		FG::Task last_task;
+		const ImVec2 origin{display_min.x + float(left) / scale.x, display_min.y + float(top) / scale.y};
+		const ImVec2 end{origin.x + float(width) / scale.x, origin.y + float(height) / scale.y};
 
-		for (int i = 0; i < draw_data->CmdListsCount; ++i)
+		std::unique_ptr<window_cache>& entry = m_window_caches[ImHashStr(cmd_list._OwnerName)];
+		if (!entry)
 		{
-			const ImDrawList& cmd_list = *draw_data->CmdLists[i];
+			entry					   = std::make_unique<window_cache>();
+			entry->m_window.m_offscreen = true;
+			if (!m_shared.m_imgui_renderer.init(entry->m_window, m_shared.m_frame_graph))
+			{
+				m_window_caches.erase(ImHashStr(cmd_list._OwnerName));
+				return nullptr;
+			}
+		}
+		window_cache& cache = *entry;
+		cache.m_last_used	= m_composite_frame;
 
-			last_task = cmdbuf->AddTask(FG::UpdateBuffer{}.SetBuffer(pw.m_vertex_buffer).AddData(cmd_list.VtxBuffer.Data, cmd_list.VtxBuffer.Size, vb_offset).DependsOn(last_task));
-			last_task = cmdbuf->AddTask(FG::UpdateBuffer{}.SetBuffer(pw.m_index_buffer).AddData(cmd_list.IdxBuffer.Data, cmd_list.IdxBuffer.Size, ib_offset).DependsOn(last_task));
+		const auto step			 = [](int size) { return (size + cache_image_step - 1) / cache_image_step * cache_image_step; };
+		const int  image_width	 = step(width);
+		const int  image_height	 = step(height);
+		if (width > cache.m_image_width or height > cache.m_image_height or cache.m_image_width > 2 * image_width or cache.m_image_height > 2 * image_height)
+		{
+			std::lock_guard<std::mutex> lock(m_shared.m_queue_mutex);
+			release_cache_image(cache);
+
+			cache.m_image = m_shared.m_frame_graph->CreateImage(
+				FG::ImageDesc{}
+					.SetDimension({FG::uint(image_width), FG::uint(image_height)})
+					.SetFormat(FG::EPixelFormat::RGBA8_UNorm)
+					.SetUsage(FG::EImageUsage::ColorAttachment | FG::EImageUsage::Sampled),
+				FG::Default, "UI.WindowCache");
+			if (!cache.m_image)
+			{
+				return nullptr;
+			}
 
-			vb_offset += cmd_list.VtxBuffer.Size * FG::SizeOf<ImDrawVert>;
-			ib_offset += cmd_list.IdxBuffer.Size * FG::SizeOf<ImDrawIdx>;
+			cache.m_texture = m_shared.m_imgui_renderer.register_texture(cache.m_image, true);
+			if (!cache.m_texture)
+			{
+				release_cache_image(cache);
+				return nullptr;
+			}
+			cache.m_image_width	 = image_width;
+			cache.m_image_height = image_height;
 		}
 
-		ASSERT(vertex_size == vb_offset);
-		ASSERT(index_size == ib_offset);
-		return last_task;
-	}
-
-	ND_ FG::Task update_uniform_buffer(imgui_renderer_window& pw, ImDrawData* draw_data, ImGuiContext* _context, const FG::CommandBuffer& cmdbuf)
-	{
-		if (not pw.m_uniform_buffer)
+		const uint64_t hash = imgui_app_fw::hash_draw_list_at(cmd_list, origin);
+		if (!cache.m_valid or hash != cache.m_hash or width != cache.m_width or height != cache.m_height or scale.x != cache.m_scale.x or scale.y != cache.m_scale.y)
 		{
-			pw.m_uniform_buffer =
-				cmdbuf->GetFrameGraph()->CreateBuffer(FG::BufferDesc{(FG::BytesU)16, FG::EBufferUsage::Uniform | FG::EBufferUsage::TransferDst}, FG::Default, "UI.UniformBuffer");
-			CHECK_ERR(pw.m_uniform_buffer);
+			cache.m_valid  = false; // until record_frame() has drawn it
+			cache.m_hash   = hash;
+			cache.m_width  = width;
+			cache.m_height = height;
+			cache.m_scale  = scale;
+			cache.m_source = &cmd_list;
+
+			ImDrawData& redraw		= cache.m_draw_data;
+			redraw.Valid			= true;
+			redraw.CmdLists			= &cache.m_source;
+			redraw.CmdListsCount	= 1;
+			redraw.TotalVtxCount	= cmd_list.VtxBuffer.Size;
+			redraw.TotalIdxCount	= cmd_list.IdxBuffer.Size;
+			redraw.DisplayPos		= origin;
+			redraw.DisplaySize		= ImVec2(float(width) / scale.x, float(height) / scale.y);
+			redraw.FramebufferScale = scale;
+			m_redraws.push_back(&cache);
 		}
 
-		FG::float4 pc_data;
-		// scale:
-		pc_data[0] = 2.0f / (draw_data->DisplaySize.x * _context->IO.DisplayFramebufferScale.x);
-		pc_data[1] = 2.0f / (draw_data->DisplaySize.y * _context->IO.DisplayFramebufferScale.y);
-		// transform:
-		pc_data[2] = -1.0f - draw_data->DisplayPos.x * pc_data[0];
-		pc_data[3] = -1.0f - draw_data->DisplayPos.y * pc_data[1];
-
-		return cmdbuf->AddTask(FG::UpdateBuffer{}.SetBuffer(pw.m_uniform_buffer).AddData(&pc_data, 1));
+		const ImVec2 uv_end{float(width) / float(cache.m_image_width), float(height) / float(cache.m_image_height)};
+		const ImU32	 white = IM_COL32_WHITE;
+
+		ImDrawList& quad = cache.m_quad;
+		quad._OwnerName	 = cmd_list._OwnerName;
+		quad.Flags		 = cmd_list.Flags;
+		quad.VtxBuffer.resize(4);
+		quad.VtxBuffer[0] = ImDrawVert{origin, ImVec2(0.0f, 0.0f), white};
+		quad.VtxBuffer[1] = ImDrawVert{ImVec2(end.x, origin.y), ImVec2(uv_end.x, 0.0f), white};
+		quad.VtxBuffer[2] = ImDrawVert{end, uv_end, white};
+		quad.VtxBuffer[3] = ImDrawVert{ImVec2(origin.x, end.y), ImVec2(0.0f, uv_end.y), white};
+
+		const ImDrawIdx indices[] = {0, 1, 2, 0, 2, 3};
+		quad.IdxBuffer.resize(6);
+		std::memcpy(quad.IdxBuffer.Data, indices, sizeof(indices));
+
+		quad.CmdBuffer.resize(1);
+		quad.CmdBuffer[0]			= ImDrawCmd();
+		quad.CmdBuffer[0].ClipRect	= ImVec4(display_min.x, display_min.y, display_max.x, display_max.y);
+		quad.CmdBuffer[0].TextureId = cache.m_texture;
+		quad.CmdBuffer[0].ElemCount = 6;
+		return &cache;
 	}
-};
 
-struct platform_window_data
-{
-	GLFWwindow* m_window;
-	bool		m_window_owned;
-	int			m_ignore_window_pos_event_frame;
-	int			m_ignore_window_size_event_frame;
-
-	platform_window_data()
+	// Call with the queue locked. What the GPU is still doing with the image and buffers holds on to them.
+	void release_window_cache(window_cache& cache)
 	{
-		m_window						 = NULL;
-		m_window_owned					 = false;
-		m_ignore_window_size_event_frame = m_ignore_window_pos_event_frame = -1;
+		release_cache_image(cache);
+		m_shared.m_imgui_renderer.destroy(cache.m_window, m_shared.m_frame_graph);
 	}
 
-	~platform_window_data()
+	// Call with the queue locked
+	void release_cache_image(window_cache& cache)
 	{
-		IM_ASSERT(m_window == NULL);
+		if (cache.m_texture)
+		{
+			m_shared.m_imgui_renderer.unregister_texture(cache.m_texture);
+			cache.m_texture = nullptr;
+		}
+		m_shared.m_frame_graph->ReleaseResource(INOUT cache.m_image);
+		cache.m_image_width	 = 0;
+		cache.m_image_height = 0;
+		cache.m_valid		 = false;
 	}
-};
 
-struct platform_device_factory : public FGC::IVulkanSurface
-{
-	GLFWwindow* m_window;
+	// Records draw_data into a command buffer that draws this viewport's swapchain image, null when there is nothing to
+	// draw. Different viewports may be recorded on different threads at once.
+	FG::CommandBuffer record_frame(ImGuiContext* ctx, ImDrawData* draw_data, FG::Task dependent_task, uint64_t resize)
+	{
+		CHECK_ERR(apply_resize(resize));
 
-	platform_device_factory(GLFWwindow* wnd) : m_window{wnd} {}
+		if (draw_data->TotalVtxCount <= 0)
+		{
+			return nullptr;
+		}
 
-	virtual ~platform_device_factory() {}
+		draw_data = composite_cached_windows(draw_data);
+		{
+			std::lock_guard<std::mutex> lock(m_shared.m_queue_mutex);
+			CHECK_ERR(m_shared.m_imgui_renderer.acquire_frame(m_imgui_window, draw_data, m_shared.m_frame_graph));
+			for (window_cache* cache : m_redraws)
+			{
+				CHECK_ERR(m_shared.m_imgui_renderer.acquire_frame(cache->m_window, &cache->m_draw_data, m_shared.m_frame_graph));
+			}
+		}
+		m_gpu_timer.begin_frame(*m_shared.m_device, m_imgui_window.m_frame_index, m_viewport_id);
 
-	FGC::ArrayView<const char*> GetRequiredExtensions() const override
-	{
-		uint32_t	 required_extension_count = 0;
-		const char** required_extensions	  = glfwGetRequiredInstanceExtensions(&required_extension_count);
+		FG::CommandBuffer cmdbuf = m_shared.m_frame_graph->Begin(FG::CommandBufferDesc{FG::EQueueType::Graphics});
+		CHECK_ERR(cmdbuf);
 
-		return FGC::ArrayView<const char*>{required_extensions, required_extension_count};
+		auto dep_tasks = FGC::ArrayView<FG::Task>{&dependent_task, dependent_task ? size_t(1) : size_t(0)};
+
+		// The cached windows that changed are redrawn first, each into its own image
+		FG::Array<FG::Task> ui_dependencies;
+		if (dependent_task)
+		{
+			ui_dependencies.push_back(dependent_task);
+		}
+		for (window_cache* cache : m_redraws)
+		{
+			imgui_app_fw::frame_stats::scoped_phase timer(imgui_app_fw::frame_stats::phase::draw);
+			const FG::float2  size{float(cache->m_width), float(cache->m_height)};
+			FG::LogicalPassID cache_pass = cmdbuf->CreateRenderPass(FG::RenderPassDesc{FG::int2{cache->m_width, cache->m_height}}
+																		.AddViewport(size)
+																		.AddTarget(FG::RenderTargetID::Color_0, cache->m_image, FG::RGBA32f{0.0f, 0.0f, 0.0f, 0.0f}, FG::EAttachmentStoreOp::Store));
+
+			FG::Task redraw = m_shared.m_imgui_renderer.draw(
+				cache->m_window, nullptr, &cache->m_draw_data, ctx, cmdbuf, cache_pass, dep_tasks,
+				[](const ImDrawList& cmd_list, const ImDrawCmd& cmd) -> FG::Task { return nullptr; });
+			if (redraw)
+			{
+				ui_dependencies.push_back(redraw);
+				cache->m_valid = true;
+			}
+		}
+
+		FG::RawImageID image = cmdbuf->GetSwapchainImage(m_swapchain_id);
+
+		FG::RGBA32f		  _clearColor{0.45f, 0.55f, 0.60f, 1.00f};
+		FG::LogicalPassID pass_id = cmdbuf->CreateRenderPass(FG::RenderPassDesc{FG::int2{FG::float2{draw_data->DisplaySize.x, draw_data->DisplaySize.y}}}
+																 .AddViewport(FG::float2{draw_data->DisplaySize.x, draw_data->DisplaySize.y})
+																 .AddTarget(FG::RenderTargetID::Color_0, image, _clearColor, FG::EAttachmentStoreOp::Store));
+		FG::Task		  draw_ui;
+		{
+			imgui_app_fw::frame_stats::scoped_phase timer(imgui_app_fw::frame_stats::phase::draw);
+			draw_ui = m_shared.m_imgui_renderer.draw(
+				m_imgui_window, &m_gpu_timer, draw_data, ctx, cmdbuf, pass_id, ui_dependencies,
+				[&cmdbuf, &pass_id](const ImDrawList& cmd_list, const ImDrawCmd& cmd) -> FG::Task {
+					return imgui_app_fw::mutable_userdata(&cmdbuf, pass_id).call(cmd_list, cmd);
+				});
+		}
+		FG::Unused(draw_ui);
+
+		return cmdbuf;
 	}
 
-	SurfaceVk_t Create(InstanceVk_t inst) const override
+	// Caller holds m_shared.m_queue_mutex
+	static void execute_frame(FG::CommandBuffer& cmdbuf)
 	{
-		VkSurfaceKHR surf = VK_NULL_HANDLE;
-		glfwCreateWindowSurface(FGC::BitCast<VkInstance>(inst), m_window, nullptr, &surf);
-		return FGC::BitCast<SurfaceVk_t>(surf);
+		CHECK_ERR(m_shared.m_frame_graph->Execute(cmdbuf));
+		m_shared.m_flush_pending = true;
 	}
 };
 
-struct platform_renderer_data
+// Records every viewport of a frame, then executes them together in the order they were added. Viewports without draw
+// callbacks are recorded on worker threads while the calling thread records the rest, so torn-off windows no longer add
+// up serially; callbacks still run one at a time on the calling thread. Workers are started on first use.
+struct viewport_recorder
 {
-	bool m_is_primary{false};
-
-	FGC::VulkanDevice2::window_specific m_window_specific;
-	FG::SwapchainID						m_swapchain_id;
-	imgui_renderer_window				m_imgui_window;
-
-	struct shared_data
+	struct job
 	{
-		FGC::UniquePtr<FGC::VulkanDevice2Initializer> m_device;
-		FG::FrameGraph								  m_frame_graph;
-		imgui_renderer								  m_imgui_renderer;
-		FG::Array<FG::Task>							  m_shared_tasks;
+		platform_renderer_data* m_renderer	= nullptr;
+		ImDrawData*				m_draw_data = nullptr;
+		uint64_t				m_resize	= 0;
+		bool					m_parallel	= false;
+		FG::CommandBuffer		m_cmdbuf;
 	};
 
-	static inline shared_data m_shared;
-
-	void init(ImGuiContext* imgui_context, ImGuiViewport* viewport, bool primary)
+	std::vector<job>		 m_jobs;
+	std::vector<std::thread> m_workers;
+	std::mutex				 m_mutex;
+	std::condition_variable	 m_work_cv;
+	std::condition_variable	 m_done_cv;
+	ImGuiContext*			 m_context		  = nullptr;
+	FG::Task				 m_dependent_task = nullptr;
+	size_t					 m_batch_size	  = 0; // jobs workers may claim from, 0 between batches
+	size_t					 m_next			  = 0; // next job to look at when claiming
+	size_t					 m_pending		  = 0; // parallel jobs of the batch not recorded yet
+	bool					 m_stop			  = false;
+
+	~viewport_recorder()
 	{
-		auto window			 = (GLFWwindow*)viewport->PlatformHandle;
-		auto surface_factory = FGC::UniquePtr<FGC::IVulkanSurface>(new platform_device_factory(window));
+		stop();
+	}
 
-		if (primary)
+	void stop()
+	{
 		{
-			auto new_device			 = std::make_unique<FGC::VulkanDevice2Initializer>();
-			auto required_extensions = surface_factory->GetRequiredExtensions();
-			new_device->CreateInstance("app_name", "engine_name", new_device->GetRecomendedInstanceLayers(), required_extensions);
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_work_cv.notify_all();
 
-			m_window_specific.CreateInstance(surface_factory, new_device->GetVkInstance());
+		for (std::thread& t : m_workers)
+		{
+			t.join();
+		}
+		m_workers.clear();
+		m_stop = false;
+	}
 
-			new_device->ChooseHighPerformanceDevice();
-			new_device->CreateLogicalDevice({{VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_SPARSE_BINDING_BIT}, {VK_QUEUE_COMPUTE_BIT}, {VK_QUEUE_TRANSFER_BIT}}, true, true, FGC::Default);
+	void add(platform_renderer_data* renderer, ImDrawData* draw_data, uint64_t resize)
+	{
+		m_jobs.push_back(job{renderer, draw_data, resize, !has_user_callbacks(draw_data)});
+	}
 
-			FG::VulkanDeviceInfo vulkan_info;
+	// Records and executes everything added since the last call, then forgets it
+	void record_and_execute(ImGuiContext* ctx, FG::Task dependent_task)
+	{
+		const size_t parallel = size_t(std::count_if(m_jobs.begin(), m_jobs.end(), [](const job& j) { return j.m_parallel; }));
+		if (parallel < 2)
+		{
+			for (job& j : m_jobs)
 			{
-				vulkan_info.instance	   = FGC::BitCast<FG::InstanceVk_t>(new_device->GetVkInstance());
-				vulkan_info.physicalDevice = FGC::BitCast<FG::PhysicalDeviceVk_t>(new_device->GetVkPhysicalDevice());
-				vulkan_info.device		   = FGC::BitCast<FG::DeviceVk_t>(new_device->GetVkDevice());
-
-				vulkan_info.maxStagingBufferMemory = ~FGC::BytesU(0);
-				vulkan_info.stagingBufferSize	   = FGC::BytesU{8 * 1024 * 1024};
+				j.m_cmdbuf = j.m_renderer->record_frame(ctx, j.m_draw_data, dependent_task, j.m_resize);
+			}
+		}
+		else
+		{
+			start_workers(parallel - 1);
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_context		 = ctx;
+				m_dependent_task = dependent_task;
+				m_batch_size	 = m_jobs.size();
+				m_next			 = 0;
+				m_pending		 = parallel;
+			}
+			m_work_cv.notify_all();
 
-				for (auto& q : new_device->GetVkQueues())
+			for (job& j : m_jobs)
+			{
+				if (!j.m_parallel)
 				{
-					FG::VulkanDeviceInfo::QueueInfo qi;
-					qi.handle	   = FGC::BitCast<FG::QueueVk_t>(q.handle);
-					qi.familyFlags = FGC::BitCast<FG::QueueFlagsVk_t>(q.familyFlags);
-					qi.familyIndex = q.familyIndex;
-					qi.priority	   = q.priority;
-					qi.debugName   = q.debugName;
-
-					vulkan_info.queues.push_back(qi);
+					j.m_cmdbuf = j.m_renderer->record_frame(ctx, j.m_draw_data, dependent_task, j.m_resize);
 				}
 			}
-			m_shared.m_frame_graph = FG::IFrameGraph::CreateFrameGraph(vulkan_info);
 
+			// help with what the workers haven't claimed yet
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while (job* j = claim())
 			{
-				auto compiler = FG::MakeShared<FG::VPipelineCompiler>(vulkan_info.instance, vulkan_info.physicalDevice, vulkan_info.device);
-				compiler->SetCompilationFlags(FG::EShaderCompilationFlags::Quiet);
-				m_shared.m_frame_graph->AddPipelineCompiler(compiler);
+				lock.unlock();
+				j->m_cmdbuf = j->m_renderer->record_frame(ctx, j->m_draw_data, dependent_task, j->m_resize);
+				lock.lock();
+				--m_pending;
 			}
-
-			m_shared.m_imgui_renderer.init_shared(imgui_context, m_shared.m_frame_graph);
-			m_shared.m_device = std::move(new_device);
+			m_done_cv.wait(lock, [this]() { return m_pending == 0; });
+			m_batch_size = 0;
 		}
-		else
+
 		{
-			m_window_specific.CreateInstance(surface_factory, m_shared.m_device->GetVkInstance());
+			imgui_app_fw::frame_stats::scoped_phase timer(imgui_app_fw::frame_stats::phase::execute);
+			std::lock_guard<std::mutex>				lock(platform_renderer_data::m_shared.m_queue_mutex);
+			for (job& j : m_jobs)
+			{
+				if (j.m_cmdbuf)
+				{
+					platform_renderer_data::execute_frame(j.m_cmdbuf);
+				}
+			}
 		}
 
-		m_shared.m_imgui_renderer.init(m_imgui_window, imgui_context, m_shared.m_frame_graph);
+		m_jobs.clear();
+	}
 
-		FG::VulkanSwapchainCreateInfo swapchain_info;
+	static bool has_user_callbacks(const ImDrawData* draw_data)
+	{
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
 		{
-			swapchain_info.surface		 = FGC::BitCast<FG::SurfaceVk_t>(m_window_specific.GetVkSurface());
-			swapchain_info.surfaceSize.x = uint32_t(viewport->Size.x);
-			swapchain_info.surfaceSize.y = uint32_t(viewport->Size.y);
+			for (const ImDrawCmd& cmd : draw_data->CmdLists[n]->CmdBuffer)
+			{
+				if (cmd.UserCallback != nullptr && cmd.UserCallback != ImDrawCallback_ResetRenderState)
+				{
+					return true;
+				}
+			}
 		}
-		m_swapchain_id			   = m_shared.m_frame_graph->CreateSwapchain(swapchain_info);
-		m_is_primary			   = primary;
-		viewport->RendererUserData = this;
+		return false;
 	}
 
-	void handle_resize(ImGuiViewport* viewport)
+	void start_workers(size_t count)
 	{
-		auto window = (GLFWwindow*)viewport->PlatformHandle;
-		int	 new_width, new_height;
-		glfwGetWindowSize(window, &new_width, &new_height);
+		const size_t max_workers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+		while (m_workers.size() < std::min(count, max_workers))
+		{
+			m_workers.emplace_back([this]() { work(); });
+		}
+	}
 
-		if (new_width > 0 && new_height > 0)
+	// Next parallel job of the batch nobody has claimed, m_mutex held
+	job* claim()
+	{
+		while (m_next < m_batch_size)
 		{
-			FG::VulkanSwapchainCreateInfo swapchain_info;
-			swapchain_info.surface		 = FG::BitCast<FG::SurfaceVk_t>(m_window_specific.GetVkSurface());
-			swapchain_info.surfaceSize.x = new_width;
-			swapchain_info.surfaceSize.y = new_height;
+			job& j = m_jobs[m_next++];
+			if (j.m_parallel)
+			{
+				return &j;
+			}
+		}
+		return nullptr;
+	}
 
-			m_shared.m_frame_graph->WaitIdle();
+	void work()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (;;)
+		{
+			m_work_cv.wait(lock, [this]() { return m_stop || m_next < m_batch_size; });
+			if (m_stop)
+			{
+				return;
+			}
 
-			m_swapchain_id = m_shared.m_frame_graph->CreateSwapchain(swapchain_info, m_swapchain_id.Release());
+			if (job* j = claim())
+			{
+				lock.unlock();
+				j->m_cmdbuf = j->m_renderer->record_frame(m_context, j->m_draw_data, m_dependent_task, j->m_resize);
+				lock.lock();
+				if (--m_pending == 0)
+				{
+					m_done_cv.notify_all();
+				}
+			}
 		}
 	}
+};
 
-	void destroy(ImGuiViewport* viewport)
+// Records, submits and presents frames on its own thread. end_frame() copies the draw data of every viewport into one of
+// three snapshots and queues it, so the application builds frame N+1 while frame N is in flight. Renderer resources are
+// only created or destroyed on the main thread after wait_idle(); swapchains are resized here, when recorded.
+struct render_thread
+{
+	static constexpr uint64_t snapshot_count = 3;
+
+	struct viewport_snapshot
 	{
-		m_shared.m_frame_graph->ReleaseResource(m_swapchain_id);
-		m_shared.m_imgui_renderer.destroy(m_imgui_window, m_shared.m_frame_graph);
+		platform_renderer_data*			 m_renderer = nullptr;
+		imgui_app_fw::draw_data_snapshot m_draw_data;
+		uint64_t						 m_resize = 0; // from take_resize()
+	};
 
-		if (m_is_primary)
+	struct frame_snapshot
+	{
+		platform_renderer_data*							m_primary = nullptr;
+		std::vector<std::unique_ptr<viewport_snapshot>> m_viewports;
+		size_t											m_viewport_count  = 0;
+		uint32_t										m_font_generation = 0; // of the atlas the UVs refer to
+
+		void add(platform_renderer_data* renderer, const ImDrawData* draw_data)
 		{
-			m_shared.m_imgui_renderer.destroy_shared(m_shared.m_frame_graph);
-			m_shared.m_frame_graph->Deinitialize();
-			m_shared.m_frame_graph = nullptr;
+			if (m_viewport_count == m_viewports.size())
+			{
+				m_viewports.emplace_back(std::make_unique<viewport_snapshot>());
+			}
 
-			m_shared.m_device->DestroyLogicalDevice();
-			m_shared.m_device->DestroyInstance();
-			m_shared.m_device.reset();
+			viewport_snapshot& v = *m_viewports[m_viewport_count++];
+			v.m_renderer		 = renderer;
+			v.m_resize			 = renderer->take_resize();
+			v.m_draw_data.copy_from(draw_data);
 		}
+	};
+
+	ImGuiContext*							   m_context = nullptr;
+	std::thread								   m_thread;
+	std::mutex								   m_mutex;
+	std::condition_variable					   m_cv;
+	std::array<frame_snapshot, snapshot_count> m_snapshots;
+	uint64_t								   m_submitted = 0; // frames queued by the main thread
+	uint64_t								   m_completed = 0; // frames presented by the render thread
+	bool									   m_stop	   = false;
+	viewport_recorder						   m_recorder;
+
+	~render_thread()
+	{
+		stop();
 	}
 
-	void end_frame()
+	bool running() const
 	{
-		CHECK_ERR(m_shared.m_frame_graph->Flush());
+		return m_thread.joinable();
 	}
 
-	FG::Task load_assets(ImGuiContext* ctx)
+	void start(ImGuiContext* ctx)
 	{
-		if (m_is_primary && !m_shared.m_imgui_renderer.m_font_texture)
+		m_context = ctx;
+		m_stop	  = false;
+		m_thread  = std::thread([this]() { run(); });
+	}
+
+	// Presents everything already queued, then joins
+	void stop()
+	{
+		if (running())
 		{
-			FG::CommandBuffer cmdbuf = m_shared.m_frame_graph->Begin(FG::CommandBufferDesc{FG::EQueueType::Graphics});
-			m_shared.m_shared_tasks.clear();
-			auto new_task = m_shared.m_imgui_renderer.create_font_texture(ctx, cmdbuf);
-			m_shared.m_frame_graph->Execute(cmdbuf);
-			return new_task;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stop = true;
+			}
+			m_cv.notify_all();
+			m_thread.join();
 		}
+	}
 
-		return nullptr;
+	void wait_idle()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_cv.wait(lock, [this]() { return m_completed == m_submitted; });
+	}
+
+	// Blocks while the render thread is two frames behind
+	frame_snapshot& acquire()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_cv.wait(lock, [this]() { return m_submitted - m_completed < snapshot_count; });
+
+		frame_snapshot& snapshot  = m_snapshots[m_submitted % snapshot_count];
+		snapshot.m_viewport_count = 0;
+		return snapshot;
+	}
+
+	void submit()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			++m_submitted;
+		}
+		m_cv.notify_all();
 	}
 
-	void render_frame(ImGuiContext* ctx, ImGuiViewport* viewport, ImDrawData* draw_data, FG::Task dependent_task)
+	void run()
 	{
-		if (draw_data->TotalVtxCount > 0)
+		for (;;)
 		{
-			FG::CommandBuffer cmdbuf = m_shared.m_frame_graph->Begin(FG::CommandBufferDesc{FG::EQueueType::Graphics});
-			CHECK_ERR(cmdbuf);
+			uint64_t frame;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_cv.wait(lock, [this]() { return m_stop || m_completed < m_submitted; });
+				if (m_completed == m_submitted)
+				{
+					return;
+				}
+				frame = m_completed;
+			}
+
+			render(m_snapshots[frame % snapshot_count]);
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				++m_completed;
+			}
+			m_cv.notify_all();
+		}
+	}
+
+	void render(frame_snapshot& snapshot)
+	{
+		// every viewport was unchanged
+		if (snapshot.m_viewport_count == 0)
+		{
+			return;
+		}
 
+		platform_renderer_data* primary		 = snapshot.m_primary;
+		FG::Task				pending_task = primary->load_assets(m_context);
+
+		// Checked after the upload, and held until the frame is executed: when the atlas was rebuilt after this frame was
+		// built, its glyph UVs no longer match the texture
+		std::shared_lock<std::shared_mutex> font_lock(platform_renderer_data::font_texture_mutex());
+		if (snapshot.m_font_generation != platform_renderer_data::uploaded_font_generation())
+		{
+			for (size_t i = 0; i < snapshot.m_viewport_count; ++i)
 			{
-				auto dep_tasks = FGC::ArrayView<FG::Task>{&dependent_task, dependent_task ? size_t(1) : size_t(0)};
+				viewport_snapshot& v = *snapshot.m_viewports[i];
+				v.m_renderer->apply_resize(v.m_resize);
+				v.m_renderer->m_frame_dropped = true;
+			}
+			return;
+		}
+
+		for (size_t i = 0; i < snapshot.m_viewport_count; ++i)
+		{
+			viewport_snapshot& v = *snapshot.m_viewports[i];
+			m_recorder.add(v.m_renderer, &v.m_draw_data.m_draw_data, v.m_resize);
+		}
+		m_recorder.record_and_execute(m_context, pending_task);
+		font_lock.unlock();
 
-				FG::RawImageID image = cmdbuf->GetSwapchainImage(m_swapchain_id);
+		primary->end_frame();
+	}
+};
+
+// One ImGui context with its own window and viewports. The init()/pump() API drives the instance, and every
+// imgui_app_fw::app owns another one.
+struct gui_primary_context
+{
+	// ImGui keeps the current context in a global, so frames of different contexts are serialized: a context is current,
+	// with s_mutex held, from begin_frame() to end_frame(), while pumping events and in GLFW callbacks.
+	static inline std::recursive_mutex s_mutex;
+
+	struct context_scope
+	{
+		std::unique_lock<std::recursive_mutex> m_lock;
+		ImGuiContext*						   m_previous;
 
-				FG::RGBA32f		  _clearColor{0.45f, 0.55f, 0.60f, 1.00f};
-				FG::LogicalPassID pass_id = cmdbuf->CreateRenderPass(FG::RenderPassDesc{FG::int2{FG::float2{draw_data->DisplaySize.x, draw_data->DisplaySize.y}}}
-																		 .AddViewport(FG::float2{draw_data->DisplaySize.x, draw_data->DisplaySize.y})
-																		 .AddTarget(FG::RenderTargetID::Color_0, image, _clearColor, FG::EAttachmentStoreOp::Store));
-				FG::Task		  draw_ui = m_shared.m_imgui_renderer.draw(
-					 m_imgui_window, draw_data, ctx, cmdbuf, pass_id, dep_tasks, 
-					 [&cmdbuf, &pass_id](const ImDrawList& cmd_list, const ImDrawCmd& cmd) -> FG::Task {
-						 return imgui_app_fw::mutable_userdata(&cmdbuf, pass_id).call(cmd_list, cmd);
-					 });
-				FG::Unused(draw_ui);
+		explicit context_scope(ImGuiContext* ctx) : m_lock{s_mutex}, m_previous{ImGui::GetCurrentContext()}
+		{
+			ImGui::SetCurrentContext(ctx);
+		}
 
-				CHECK_ERR(m_shared.m_frame_graph->Execute(cmdbuf));
-			}
+		~context_scope()
+		{
+			ImGui::SetCurrentContext(m_previous);
 		}
-	}
-};
+	};
+
+	// Bumped by the GLFW monitor callback, which is process-wide
+	static inline std::atomic<uint32_t> s_monitor_generation{0};
 
-struct gui_primary_context
-{
 	ImGuiContext* m_context = nullptr;
 
 	GLFWwindow* m_window								= nullptr;
 	double		m_time									= 0.0;
 	bool		m_mouse_pressed[ImGuiMouseButton_COUNT] = {};
 	GLFWcursor* m_mouse_cursors[ImGuiMouseCursor_COUNT] = {};
-	bool		m_need_monitor_update					= true;
-	bool		m_ready									= false;
+	uint32_t	m_monitor_generation					= 0;
+	bool		m_ready									= false; // the first frame was presented and the window shown
+	bool		m_is_default							= false; // driven by init()/pump(), the only one that records captures
+
+	render_thread				 m_render_thread;
+	viewport_recorder			 m_recorder; // for end_frame() without the render thread
+	std::optional<context_scope> m_frame_scope;
+
+	int									  m_refresh_rate = 60; // Hz of the primary monitor, paces frames that present nothing
+	std::chrono::steady_clock::time_point m_frame_end;
 
 	gui_primary_context(ImVec2 p, ImVec2 s)
 	{
-		if (!glfwInit())
+		std::lock_guard<std::recursive_mutex> lock(s_mutex);
 		{
-			throw std::exception("glfw creation failed");
+			imgui_app_fw::startup::scoped_step step("glfw_init");
+			if (!glfwInit())
+			{
+				throw std::exception("glfw creation failed");
+			}
 		}
 
+		// Hidden until the first frame is presented, see show_first_frame()
+		imgui_app_fw::startup::scoped_step step("create_window");
 		glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 		m_window = glfwCreateWindow(int(s.x), int(s.y), "", NULL, NULL);
+		glfwSetWindowUserPointer(m_window, this);
 	}
 
 	~gui_primary_context()
 	{
-		shutdown_renderer();
-		shutdown_window();
-		ImGui::DestroyContext();
-		m_context = nullptr;
+		m_frame_scope.reset();
+
+		if (m_context)
+		{
+			{
+				context_scope scope(m_context);
+				shutdown_renderer();
+				shutdown_window();
+			}
+
+			{
+				std::lock_guard<std::recursive_mutex> lock(s_mutex);
+				ImGui::DestroyContext(m_context);
+			}
+			m_context = nullptr;
 
+			platform_renderer_data::release_shared();
+		}
+
+		std::lock_guard<std::recursive_mutex> lock(s_mutex);
 		destroy_window();
 	}
 
+	static gui_primary_context* from_window(GLFWwindow* window)
+	{
+		return (gui_primary_context*)glfwGetWindowUserPointer(window);
+	}
+
+	// The context that owns the current ImGui context, for ImGui's platform and renderer callbacks
+	static gui_primary_context* current()
+	{
+		return (gui_primary_context*)ImGui::GetIO().BackendPlatformUserData;
+	}
+
+	// Idle mode belongs to the init()/pump() API, apps always poll
+	void notify_activity()
+	{
+		if (m_is_default)
+		{
+			imgui_app_fw::notify_activity();
+		}
+	}
+
 	void on_mouse_button(GLFWwindow* window, int button, int action, int mods)
 	{
+		notify_activity();
+
 		if (action == GLFW_PRESS && button >= 0 && button < IM_ARRAYSIZE(m_mouse_pressed))
 		{
 			m_mouse_pressed[button] = true;
@@ -962,6 +2965,9 @@ struct gui_primary_context
 
 	void on_scroll(GLFWwindow* window, double xoffset, double yoffset)
 	{
+		notify_activity();
+		context_scope scope(m_context);
+
 		ImGuiIO& io = ImGui::GetIO();
 		io.MouseWheelH += (float)xoffset;
 		io.MouseWheel += (float)yoffset;
@@ -969,6 +2975,9 @@ struct gui_primary_context
 
 	void on_key(GLFWwindow* window, int key, int scancode, int action, int mods)
 	{
+		notify_activity();
+		context_scope scope(m_context);
+
 		ImGuiIO& io = ImGui::GetIO();
 		if (action == GLFW_PRESS)
 		{
@@ -993,12 +3002,18 @@ struct gui_primary_context
 
 	void on_char(GLFWwindow* window, unsigned int c)
 	{
+		notify_activity();
+		context_scope scope(m_context);
+
 		ImGuiIO& io = ImGui::GetIO();
 		io.AddInputCharacter(c);
 	}
 
 	void on_window_size(GLFWwindow* window, int, int)
 	{
+		notify_activity();
+		context_scope scope(m_context);
+
 		if (ImGuiViewport* viewport = ImGui::FindViewportByPlatformHandle(window))
 		{
 			if (platform_window_data* data = (platform_window_data*)viewport->PlatformUserData)
@@ -1014,6 +3029,64 @@ struct gui_primary_context
 		}
 	}
 
+	// The window contents were damaged, the next frame has to be presented even if it is unchanged
+	void on_window_refresh(GLFWwindow* window)
+	{
+		notify_activity();
+		context_scope scope(m_context);
+
+		if (ImGuiViewport* viewport = ImGui::FindViewportByPlatformHandle(window))
+		{
+			if (platform_renderer_data* data = (platform_renderer_data*)viewport->RendererUserData)
+			{
+				data->invalidate_presented();
+			}
+		}
+	}
+
+	// Events that don't feed ImGui directly but still mean the screen may need to change (hover, focus, expose)
+	static void install_activity_callbacks(GLFWwindow* window)
+	{
+		glfwSetCursorPosCallback(window, [](GLFWwindow* window, double, double) -> void { from_window(window)->notify_activity(); });
+		glfwSetCursorEnterCallback(window, [](GLFWwindow* window, int) -> void { from_window(window)->notify_activity(); });
+		glfwSetWindowFocusCallback(window, [](GLFWwindow* window, int) -> void { from_window(window)->notify_activity(); });
+		glfwSetWindowRefreshCallback(window, [](GLFWwindow* window) -> void { from_window(window)->on_window_refresh(window); });
+	}
+
+	static void remove_activity_callbacks(GLFWwindow* window)
+	{
+		glfwSetCursorPosCallback(window, nullptr);
+		glfwSetCursorEnterCallback(window, nullptr);
+		glfwSetWindowFocusCallback(window, nullptr);
+		glfwSetWindowRefreshCallback(window, nullptr);
+	}
+
+	void on_window_close(GLFWwindow* window)
+	{
+		context_scope scope(m_context);
+		if (ImGuiViewport* viewport = ImGui::FindViewportByPlatformHandle(window))
+		{
+			viewport->PlatformRequestClose = true;
+		}
+	}
+
+	void on_window_pos(GLFWwindow* window, int, int)
+	{
+		context_scope scope(m_context);
+		if (ImGuiViewport* viewport = ImGui::FindViewportByPlatformHandle(window))
+		{
+			if (platform_window_data* data = (platform_window_data*)viewport->PlatformUserData)
+			{
+				bool ignore_event = (ImGui::GetFrameCount() <= data->m_ignore_window_pos_event_frame + 1);
+				if (ignore_event)
+				{
+					return;
+				}
+			}
+			viewport->PlatformRequestMove = true;
+		}
+	}
+
 	void update_monitors()
 	{
 		ImGuiPlatformIO& platform_io	= ImGui::GetPlatformIO();
@@ -1041,8 +3114,12 @@ struct gui_primary_context
 			glfwGetMonitorContentScale(glfw_monitors[n], &x_scale, &y_scale);
 			monitor.DpiScale = x_scale;
 			platform_io.Monitors.push_back(monitor);
+
+			if (n == 0 && vid_mode->refreshRate > 0)
+			{
+				m_refresh_rate = vid_mode->refreshRate;
+			}
 		}
-		m_need_monitor_update = false;
 	}
 
 	bool init_window(GLFWwindow* window)
@@ -1057,6 +3134,7 @@ struct gui_primary_context
 		io.BackendFlags |= ImGuiBackendFlags_PlatformHasViewports;	  // We can create multi-viewports on the Platform side (optional)
 		io.BackendFlags |= ImGuiBackendFlags_HasMouseHoveredViewport; // We can set io.MouseHoveredViewport correctly (optional, not easy)
 		io.BackendPlatformName = "imgui_impl_glfw";
+		io.BackendPlatformUserData = this;
 
 		// Keyboard mapping. ImGui will use those indices to peek into the io.KeysDown[] array.
 		io.KeyMap[ImGuiKey_Tab]			= GLFW_KEY_TAB;
@@ -1108,13 +3186,15 @@ struct gui_primary_context
 		m_mouse_cursors[ImGuiMouseCursor_NotAllowed] = glfwCreateStandardCursor(GLFW_NOT_ALLOWED_CURSOR);
 		glfwSetErrorCallback(prev_error_callback);
 
-		glfwSetMouseButtonCallback(window, [](GLFWwindow* window, int button, int action, int mods) -> void { instance->on_mouse_button(window, button, action, mods); });
-		glfwSetScrollCallback(window, [](GLFWwindow* window, double xoffset, double yoffset) -> void { instance->on_scroll(window, xoffset, yoffset); });
-		glfwSetKeyCallback(window, [](GLFWwindow* window, int key, int scancode, int action, int mods) -> void { instance->on_key(window, key, scancode, action, mods); });
-		glfwSetCharCallback(window, [](GLFWwindow* window, unsigned int c) -> void { instance->on_char(window, c); });
-		glfwSetMonitorCallback([](GLFWmonitor*, int) -> void { instance->m_need_monitor_update = true; });
+		glfwSetMouseButtonCallback(window, [](GLFWwindow* window, int button, int action, int mods) -> void { from_window(window)->on_mouse_button(window, button, action, mods); });
+		glfwSetScrollCallback(window, [](GLFWwindow* window, double xoffset, double yoffset) -> void { from_window(window)->on_scroll(window, xoffset, yoffset); });
+		glfwSetKeyCallback(window, [](GLFWwindow* window, int key, int scancode, int action, int mods) -> void { from_window(window)->on_key(window, key, scancode, action, mods); });
+		glfwSetCharCallback(window, [](GLFWwindow* window, unsigned int c) -> void { from_window(window)->on_char(window, c); });
+		glfwSetMonitorCallback([](GLFWmonitor*, int) -> void { s_monitor_generation.fetch_add(1, std::memory_order_relaxed); });
+		install_activity_callbacks(window);
 
 		// Update monitors the first time (note: monitor callback are broken in GLFW 3.2 and earlier, see github.com/glfw/glfw/issues/784)
+		m_monitor_generation = s_monitor_generation.load(std::memory_order_relaxed);
 		update_monitors();
 
 		// Our mouse update function expect PlatformHandle to be filled for the main viewport
@@ -1145,41 +3225,26 @@ struct gui_primary_context
 				viewport->PlatformHandleRaw = glfwGetWin32Window(data->m_window);
 #endif
 				glfwSetWindowPos(data->m_window, (int)viewport->Pos.x, (int)viewport->Pos.y);
+				glfwSetWindowUserPointer(data->m_window, current());
 
 				// Install GLFW callbacks for secondary viewports
 				glfwSetMouseButtonCallback(
-					data->m_window, [](GLFWwindow* window, int button, int action, int mods) -> void { instance->on_mouse_button(window, button, action, mods); });
+					data->m_window, [](GLFWwindow* window, int button, int action, int mods) -> void { from_window(window)->on_mouse_button(window, button, action, mods); });
 
-				glfwSetScrollCallback(data->m_window, [](GLFWwindow* window, double xoffset, double yoffset) -> void { instance->on_scroll(window, xoffset, yoffset); });
+				glfwSetScrollCallback(data->m_window, [](GLFWwindow* window, double xoffset, double yoffset) -> void { from_window(window)->on_scroll(window, xoffset, yoffset); });
 
 				glfwSetKeyCallback(
-					data->m_window, [](GLFWwindow* window, int key, int scancode, int action, int mods) -> void { instance->on_key(window, key, scancode, action, mods); });
+					data->m_window, [](GLFWwindow* window, int key, int scancode, int action, int mods) -> void { from_window(window)->on_key(window, key, scancode, action, mods); });
 
-				glfwSetCharCallback(data->m_window, [](GLFWwindow* window, unsigned int c) -> void { instance->on_char(window, c); });
+				glfwSetCharCallback(data->m_window, [](GLFWwindow* window, unsigned int c) -> void { from_window(window)->on_char(window, c); });
 
-				glfwSetWindowSizeCallback(data->m_window, [](GLFWwindow* window, int a, int b) -> void { instance->on_window_size(window, a, b); });
+				glfwSetWindowSizeCallback(data->m_window, [](GLFWwindow* window, int a, int b) -> void { from_window(window)->on_window_size(window, a, b); });
 
-				glfwSetWindowCloseCallback(data->m_window, [](GLFWwindow* window) -> void {
-					if (ImGuiViewport* viewport = ImGui::FindViewportByPlatformHandle(window))
-					{
-						viewport->PlatformRequestClose = true;
-					}
-				});
+				install_activity_callbacks(data->m_window);
 
-				glfwSetWindowPosCallback(data->m_window, [](GLFWwindow* window, int, int) -> void {
-					if (ImGuiViewport* viewport = ImGui::FindViewportByPlatformHandle(window))
-					{
-						if (platform_window_data* data = (platform_window_data*)viewport->PlatformUserData)
-						{
-							bool ignore_event = (ImGui::GetFrameCount() <= data->m_ignore_window_pos_event_frame + 1);
-							if (ignore_event)
-							{
-								return;
-							}
-						}
-						viewport->PlatformRequestMove = true;
-					}
-				});
+				glfwSetWindowCloseCallback(data->m_window, [](GLFWwindow* window) -> void { from_window(window)->on_window_close(window); });
+
+				glfwSetWindowPosCallback(data->m_window, [](GLFWwindow* window, int x, int y) -> void { from_window(window)->on_window_pos(window, x, y); });
 			};
 
 			platform_io.Platform_DestroyWindow = [](ImGuiViewport* viewport) -> void {
@@ -1259,14 +3324,6 @@ struct gui_primary_context
 				glfwSetWindowTitle(data->m_window, title);
 			};
 
-			platform_io.Platform_RenderWindow = [](ImGuiViewport* viewport, void*) -> void {
-				platform_window_data* data = (platform_window_data*)viewport->PlatformUserData;
-			};
-
-			platform_io.Platform_SwapBuffers = [](ImGuiViewport* viewport, void*) -> void {
-				platform_window_data* data = (platform_window_data*)viewport->PlatformUserData;
-			};
-
 			platform_io.Platform_SetWindowAlpha = [](ImGuiViewport* viewport, float alpha) -> void {
 				platform_window_data* data = (platform_window_data*)viewport->PlatformUserData;
 				glfwSetWindowOpacity(data->m_window, alpha);
@@ -1296,7 +3353,7 @@ struct gui_primary_context
 			main_viewport->PlatformHandle		= (void*)m_window;
 		}
 
-		glfwSetWindowSizeCallback(m_window, [](GLFWwindow* window, int a, int b) -> void { instance->on_window_size(window, a, b); });
+		glfwSetWindowSizeCallback(m_window, [](GLFWwindow* window, int a, int b) -> void { from_window(window)->on_window_size(window, a, b); });
 
 		return true;
 	}
@@ -1307,13 +3364,16 @@ struct gui_primary_context
 		glfwSetScrollCallback(m_window, nullptr);
 		glfwSetKeyCallback(m_window, nullptr);
 		glfwSetCharCallback(m_window, nullptr);
-		glfwSetMonitorCallback(nullptr);
+		glfwSetWindowSizeCallback(m_window, nullptr);
+		remove_activity_callbacks(m_window);
 
 		for (ImGuiMouseCursor cursor_n = 0; cursor_n < ImGuiMouseCursor_COUNT; cursor_n++)
 		{
 			glfwDestroyCursor(m_mouse_cursors[cursor_n]);
 			m_mouse_cursors[cursor_n] = NULL;
 		}
+
+		ImGui::GetIO().BackendPlatformUserData = nullptr;
 	}
 
 	void update_mouse_pos_and_buttons()
@@ -1473,7 +3533,7 @@ struct gui_primary_context
 		}
 	}
 
-	bool init_renderer(ImGuiContext* imgui_context)
+	bool init_renderer(platform_renderer_data* primary_viewport_data)
 	{
 		// Setup back-end capabilities flags
 		ImGuiIO& io			   = ImGui::GetIO();
@@ -1481,12 +3541,12 @@ struct gui_primary_context
 		io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset; // We can honor the ImDrawCmd::VtxOffset field, allowing for large meshes.
 		io.BackendFlags |= ImGuiBackendFlags_RendererHasViewports; // We can create multi-viewports on the Renderer side (optional) // FIXME-VIEWPORT: Actually unfinished..
 
-		// Create a dummy platform_renderer_data holder for the main viewport,
-		// Since this is created and managed by the application, we will only use the ->Resources[] fields.
+		// The main viewport's renderer data was created by init() together with the device
 		ImGuiViewport* main_viewport = ImGui::GetMainViewport();
-
-		auto primary_viewport_data = IM_NEW(platform_renderer_data);
-		primary_viewport_data->init(imgui_context, main_viewport, true);
+		{
+			imgui_app_fw::startup::scoped_step step("swapchain");
+			primary_viewport_data->init(main_viewport, true);
+		}
 
 		// Setup back-end capabilities flags
 		io.BackendFlags |= ImGuiBackendFlags_RendererHasViewports; // We can create multi-viewports on the Renderer side (optional)
@@ -1494,18 +3554,13 @@ struct gui_primary_context
 		{
 			ImGuiPlatformIO& platform_io	  = ImGui::GetPlatformIO();
 			platform_io.Renderer_CreateWindow = [](ImGuiViewport* viewport) -> void {
-				instance->create_secondary_window(viewport);
+				current()->create_secondary_window(viewport);
 			};
 			platform_io.Renderer_DestroyWindow = [](ImGuiViewport* viewport) -> void {
-				instance->destroy_secondary_window(viewport);
+				current()->destroy_secondary_window(viewport);
 			};
 			platform_io.Renderer_SetWindowSize = [](ImGuiViewport* viewport, ImVec2 size) -> void {
-				instance->set_secondary_window_size(viewport, size);
-			};
-			platform_io.Renderer_RenderWindow = [](ImGuiViewport* viewport, void*) -> void {
-				instance->render_secondary_window(viewport);
-			};
-			platform_io.Renderer_SwapBuffers = [](ImGuiViewport* viewport, void*) -> void {
+				current()->set_secondary_window_size(viewport, size);
 			};
 		}
 
@@ -1514,6 +3569,8 @@ struct gui_primary_context
 
 	void shutdown_renderer()
 	{
+		m_render_thread.stop();
+
 		// Manually delete main viewport render resources in-case we haven't initialized for viewports
 		ImGuiViewport*			main_viewport	   = ImGui::GetMainViewport();
 		platform_renderer_data* main_viewport_data = (platform_renderer_data*)main_viewport->RendererUserData;
@@ -1524,8 +3581,11 @@ struct gui_primary_context
 
 		// destroy_device_objects();
 
-		main_viewport_data->destroy(main_viewport);
-		IM_DELETE(main_viewport_data);
+		if (main_viewport_data)
+		{
+			main_viewport_data->destroy(main_viewport);
+			IM_DELETE(main_viewport_data);
+		}
 	}
 
 	void new_frame()
@@ -1545,8 +3605,9 @@ struct gui_primary_context
 			io.DisplayFramebufferScale = ImVec2((float)display_w / w, (float)display_h / h);
 		}
 
-		if (m_need_monitor_update)
+		if (const uint32_t generation = s_monitor_generation.load(std::memory_order_relaxed); generation != m_monitor_generation)
 		{
+			m_monitor_generation = generation;
 			update_monitors();
 		}
 
@@ -1561,13 +3622,18 @@ struct gui_primary_context
 
 	void create_secondary_window(ImGuiViewport* viewport)
 	{
+		m_render_thread.wait_idle();
+
 		platform_renderer_data* data = IM_NEW(platform_renderer_data)();
 		viewport->RendererUserData	 = data;
-		data->init(ImGui::GetCurrentContext(), viewport, false);
+		data->create_device((GLFWwindow*)viewport->PlatformHandle);
+		data->init(viewport, false);
 	}
 
 	void destroy_secondary_window(ImGuiViewport* viewport)
 	{
+		m_render_thread.wait_idle();
+
 		// The main viewport (owned by the application) will always have RendererUserData == nullptr since we didn't create the data for it.
 		if (platform_renderer_data* data = (platform_renderer_data*)viewport->RendererUserData)
 		{
@@ -1585,16 +3651,9 @@ struct gui_primary_context
 
 	FG::Task m_pending_task = nullptr;
 
-	void render_secondary_window(ImGuiViewport* viewport)
-	{
-		const ImVec4 clear_color = ImVec4(0.0f, 0.0f, 0.0f, 1.0f);
-
-		platform_renderer_data* data = (platform_renderer_data*)viewport->RendererUserData;
-		data->render_frame(ImGui::GetCurrentContext(), viewport, viewport->DrawData, m_pending_task);
-	}
-
 	void set_window_title(const char* title)
 	{
+		std::lock_guard<std::recursive_mutex> lock(s_mutex);
 		glfwSetWindowTitle(m_window, title);
 	}
 
@@ -1609,79 +3668,201 @@ struct gui_primary_context
 		glfwShowWindow(m_window);
 	}
 
-	void begin_frame()
+	// The window stays hidden through startup so it never shows an empty frame
+	void show_first_frame()
 	{
-		new_frame();
+		m_render_thread.wait_idle();
+		show_window();
+		m_ready = true;
+	}
 
+	void handle_main_viewport_resize()
+	{
 		if (ImGuiViewport* main_viewport = ImGui::GetMainViewport(); main_viewport->PlatformRequestResize)
 		{
 			((platform_renderer_data*)main_viewport->RendererUserData)->handle_resize(main_viewport);
 			main_viewport->PlatformRequestResize = false;
 		}
+	}
 
+	void begin_frame()
+	{
+		m_frame_scope.emplace(m_context);
+		platform_renderer_data::update_font_atlas();
+		new_frame();
+		handle_main_viewport_resize();
 		ImGui::NewFrame();
 	}
 
-	void end_frame(ImVec4 clear_color)
+	// Calls add(renderer, draw data) for every viewport that has to be rendered this frame, main viewport first. Returns how
+	// many there were.
+	template <typename F>
+	int for_each_viewport_to_render(ImDrawData* draw_data, F&& add)
 	{
-		ImGui::Render();
-
-		ImGuiViewport*			main_viewport	   = ImGui::GetMainViewport();
-		platform_renderer_data* main_viewport_data = (platform_renderer_data*)main_viewport->RendererUserData;
+		int count = 0;
 
-		if (main_viewport->PlatformRequestResize)
+		platform_renderer_data* main_viewport_data = (platform_renderer_data*)ImGui::GetMainViewport()->RendererUserData;
+		if (main_viewport_data->needs_render(draw_data))
 		{
-			main_viewport_data->handle_resize(main_viewport);
-			main_viewport->PlatformRequestResize = false;
+			add(main_viewport_data, draw_data);
+			++count;
 		}
 
 		if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 		{
-			ImGui::UpdatePlatformWindows();
+			// same selection as ImGui::RenderPlatformWindowsDefault
+			ImGuiPlatformIO& platform_io = ImGui::GetPlatformIO();
+			for (int i = 1; i < platform_io.Viewports.Size; ++i)
+			{
+				ImGuiViewport* viewport = platform_io.Viewports[i];
+				platform_renderer_data* data = (platform_renderer_data*)viewport->RendererUserData;
+				if ((viewport->Flags & ImGuiViewportFlags_Minimized) == 0 && data && viewport->DrawData && data->needs_render(viewport->DrawData))
+				{
+					add(data, viewport->DrawData);
+					++count;
+				}
+			}
 		}
+		return count;
+	}
+
+	// A frame that presents nothing doesn't block on vsync, so without this a static UI would build frames as fast as the
+	// CPU allows. Sleeps out the rest of the primary monitor's refresh period since the previous frame ended.
+	void pace_frame(bool presented)
+	{
+		using clock = std::chrono::steady_clock;
+
+		if (!presented)
+		{
+			const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / m_refresh_rate));
+			std::this_thread::sleep_until(m_frame_end + period);
+		}
+		m_frame_end = clock::now();
+	}
+
+	// Hands copies of this frame's draw data to the render thread, which does what the rest of end_frame() does inline.
+	// Returns the number of viewports it will present.
+	int queue_frame(ImDrawData* draw_data)
+	{
+		ImGuiViewport*				   main_viewport = ImGui::GetMainViewport();
+		render_thread::frame_snapshot& snapshot		 = m_render_thread.acquire();
+
+		snapshot.m_primary		   = (platform_renderer_data*)main_viewport->RendererUserData;
+		snapshot.m_font_generation = platform_renderer_data::font_generation();
+		const int count = for_each_viewport_to_render(draw_data, [&snapshot](platform_renderer_data* data, ImDrawData* viewport_draw_data) {
+			snapshot.add(data, viewport_draw_data);
+		});
+
+		m_render_thread.submit();
+		return count;
+	}
+
+	void end_frame(ImVec4 clear_color)
+	{
+		{
+			imgui_app_fw::frame_stats::scoped_phase timer(imgui_app_fw::frame_stats::phase::render);
+			ImGui::Render();
+		}
+
+		ImDrawData* draw_data = m_is_default ? imgui_app_fw::process_frame_draw_data(ImGui::GetDrawData()) : ImGui::GetDrawData();
 
-		m_pending_task = main_viewport_data->load_assets(m_context);
-		main_viewport_data->render_frame(m_context, main_viewport, ImGui::GetDrawData(), m_pending_task);
+		handle_main_viewport_resize();
 
 		if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 		{
-			ImGui::RenderPlatformWindowsDefault(nullptr, nullptr);
+			ImGui::UpdatePlatformWindows();
+		}
+
+		if (m_render_thread.running())
+		{
+			const int presented = queue_frame(draw_data);
+			if (!m_ready)
+			{
+				show_first_frame();
+			}
+			m_frame_scope.reset();
+			pace_frame(presented > 0);
+			return;
 		}
+
+		ImGuiViewport*			main_viewport	   = ImGui::GetMainViewport();
+		platform_renderer_data* main_viewport_data = (platform_renderer_data*)main_viewport->RendererUserData;
+
+		// Every viewport is recorded and executed together instead of one by one through ImGui::RenderPlatformWindowsDefault,
+		// whose platform render and swap callbacks have nothing to do here
+		m_pending_task		= main_viewport_data->load_assets(m_context);
+		const int presented = for_each_viewport_to_render(draw_data, [this](platform_renderer_data* data, ImDrawData* viewport_draw_data) {
+			m_recorder.add(data, viewport_draw_data, data->take_resize());
+		});
+		m_recorder.record_and_execute(m_context, m_pending_task);
+		m_frame_scope.reset();
+
 		main_viewport_data->end_frame();
+
+		if (!m_ready)
+		{
+			std::lock_guard<std::recursive_mutex> lock(s_mutex);
+			show_first_frame();
+		}
+
+		pace_frame(presented > 0);
 	}
 
 	bool init()
 	{
-		show_window();
+		context_scope scope(nullptr);
 
-		// Setup Dear ImGui context
-		IMGUI_CHECKVERSION();
+		// Every context draws with the same font atlas, so the font texture is built and uploaded once, and again only when
+		// begin_frame() rebuilds the atlas for glyphs requested through imgui_app_fw::fonts
+		ImFontAtlas* font_atlas = platform_renderer_data::acquire_shared();
+
+		// Vulkan device creation, pipeline compilation and the transcoder tables don't depend on ImGui: they run on worker
+		// threads while the context, window callbacks and fonts are set up here. end_frame() shows the window.
+		auto primary_viewport_data = IM_NEW(platform_renderer_data)();
+		auto device_ready		   = std::async(std::launch::async, [primary_viewport_data, window = m_window]() { return primary_viewport_data->create_device(window); });
+		auto transcoder_ready	   = std::async(std::launch::async, []() {
+			imgui_app_fw::startup::scoped_step step("basis_transcoder");
+
+			static std::once_flag once;
+			std::call_once(once, []() { basist::basisu_transcoder_init(); });
+		});
 
-		m_context	= ImGui::CreateContext();
-		ImGuiIO& io = ImGui::GetIO();
-		io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard; // Enable Keyboard Controls
-		// io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
-		io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;	// Enable Docking
-		io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable; // Enable Multi-Viewport / Platform Windows
-		// io.ConfigViewportsNoAutoMerge = true;
-		// io.ConfigViewportsNoTaskBarIcon = true;
-
-		// Setup Dear ImGui style
-		ImGui::StyleColorsDark();
-		// ImGui::StyleColorsClassic();
-
-		// When viewports are enabled we tweak WindowRounding/WindowBg so platform windows can look identical to regular ones.
-		ImGuiStyle& style = ImGui::GetStyle();
-		if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 		{
-			style.WindowRounding			  = 0.0f;
-			style.Colors[ImGuiCol_WindowBg].w = 1.0f;
+			imgui_app_fw::startup::scoped_step step("imgui_context");
+
+			// Setup Dear ImGui context
+			IMGUI_CHECKVERSION();
+
+			m_context = ImGui::CreateContext(font_atlas);
+			ImGui::SetCurrentContext(m_context);
+
+			ImGuiIO& io = ImGui::GetIO();
+			io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard; // Enable Keyboard Controls
+			// io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
+			io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;	// Enable Docking
+			io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable; // Enable Multi-Viewport / Platform Windows
+			// io.ConfigViewportsNoAutoMerge = true;
+			// io.ConfigViewportsNoTaskBarIcon = true;
+
+			// Setup Dear ImGui style
+			ImGui::StyleColorsDark();
+			// ImGui::StyleColorsClassic();
+
+			// When viewports are enabled we tweak WindowRounding/WindowBg so platform windows can look identical to regular ones.
+			ImGuiStyle& style = ImGui::GetStyle();
+			if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+			{
+				style.WindowRounding			  = 0.0f;
+				style.Colors[ImGuiCol_WindowBg].w = 1.0f;
+			}
 		}
 
-		// Setup Platform/Renderer bindings
-		init_window(m_window);
+		{
+			imgui_app_fw::startup::scoped_step step("platform_window");
 
-		init_renderer(m_context);
+			// Setup Platform bindings
+			init_window(m_window);
+		}
 
 		// Load Fonts
 		// - If no fonts are loaded, dear imgui will use the default font. You can also load multiple fonts and use ImGui::PushFont()/PopFont() to select them.
@@ -1689,7 +3870,7 @@ struct gui_primary_context
 		// - If the file cannot be loaded, the function will return nullptr. Please handle those errors in your application (e.g. use an assertion, or display an error and
 		// quit).
 		// - The fonts will be rasterized at a given size (w/ oversampling) and stored into a texture when calling ImFontAtlas::Build()/GetTexDataAsXXXX(), which
-		// ImGui_ImplXXXX_NewFrame below will call.
+		// build_font_atlas() below calls. Fonts added through imgui_app_fw::fonts rasterize only the glyphs the application requests.
 		// - Read 'docs/FONTS.md' for more instructions and details.
 		// - Remember that in C/C++ if you want to include a backslash \ in a string literal you need to write a double backslash \\ !
 		// io.Fonts->AddFontDefault();
@@ -1699,18 +3880,66 @@ struct gui_primary_context
 		// io.Fonts->AddFontFromFileTTF("../../misc/fonts/ProggyTiny.ttf", 10.0f);
 		// ImFont* font = io.Fonts->AddFontFromFileTTF("c:\\Windows\\Fonts\\ArialUni.ttf", 18.0f, nullptr, io.Fonts->GetGlyphRangesJapanese());
 		// IM_ASSERT(font != nullptr);
+		{
+			imgui_app_fw::startup::scoped_step step("font_atlas");
+			platform_renderer_data::build_font_atlas();
+		}
+
+		bool device_created;
+		{
+			imgui_app_fw::startup::scoped_step step("wait_for_device");
+			device_created = device_ready.get();
+			transcoder_ready.wait();
+		}
+
+		if (!device_created)
+		{
+			IM_DELETE(primary_viewport_data);
+			return false;
+		}
 
-		basist::basisu_transcoder_init();
+		// Setup Renderer bindings
+		init_renderer(primary_viewport_data);
+
+		if (imgui_app_fw::threaded_rendering_requested())
+		{
+			m_render_thread.start(m_context);
+		}
+
+		// The init()/pump() API expects its context to stay current
+		if (m_is_default)
+		{
+			scope.m_previous = m_context;
+		}
 
 		return true;
 	}
 
 	bool pump_events()
 	{
+		context_scope scope(m_context);
 		glfwPollEvents();
 		return !glfwWindowShouldClose(m_window);
 	}
 
+	bool wait_events(double timeout_seconds)
+	{
+		if (timeout_seconds < 0.0)
+		{
+			glfwWaitEvents();
+		}
+		else
+		{
+			glfwWaitEventsTimeout(timeout_seconds);
+		}
+		return !glfwWindowShouldClose(m_window);
+	}
+
+	void request_quit()
+	{
+		glfwSetWindowShouldClose(m_window, GLFW_TRUE);
+	}
+
 	static inline std::unique_ptr<gui_primary_context> instance;
 };
 
@@ -1721,7 +3950,8 @@ void set_window_title_glfw_vulkan(const char* title)
 
 bool init_gui_glfw_vulkan()
 {
-	gui_primary_context::instance = std::unique_ptr<gui_primary_context>(new gui_primary_context({100.0f, 100.0f}, {1280.0f, 800.0f}));
+	gui_primary_context::instance				= std::unique_ptr<gui_primary_context>(new gui_primary_context({100.0f, 100.0f}, {1280.0f, 800.0f}));
+	gui_primary_context::instance->m_is_default = true;
 	return gui_primary_context::instance->init();
 }
 
@@ -1745,8 +3975,103 @@ void end_frame_gui_glfw_vulkan(ImVec4 clear_color)
 	gui_primary_context::instance->end_frame(clear_color);
 }
 
+void request_quit_glfw_vulkan()
+{
+	gui_primary_context::instance->request_quit();
+}
+
+bool wait_events_gui_glfw_vulkan(double timeout_seconds)
+{
+	return gui_primary_context::instance->wait_events(timeout_seconds);
+}
+
+void wake_gui_glfw_vulkan()
+{
+	// Thread-safe, unblocks glfwWaitEvents on the main thread
+	glfwPostEmptyEvent();
+}
+
+struct imgui_app_fw::app_backend
+{
+	gui_primary_context m_context;
+
+	app_backend(ImVec2 p, ImVec2 s) : m_context{p, s} {}
+};
+
+imgui_app_fw::app_backend* create_app_glfw_vulkan(const char* title, int width, int height)
+{
+	auto app = std::make_unique<imgui_app_fw::app_backend>(ImVec2{100.0f, 100.0f}, ImVec2{float(width), float(height)});
+	if (!app->m_context.init())
+	{
+		return nullptr;
+	}
+
+	app->m_context.set_window_title(title);
+	return app.release();
+}
+
+void destroy_app_glfw_vulkan(imgui_app_fw::app_backend* app)
+{
+	delete app;
+}
+
+bool pump_app_glfw_vulkan(imgui_app_fw::app_backend* app)
+{
+	return app->m_context.pump_events();
+}
+
+void begin_frame_app_glfw_vulkan(imgui_app_fw::app_backend* app)
+{
+	app->m_context.begin_frame();
+}
+
+void end_frame_app_glfw_vulkan(imgui_app_fw::app_backend* app, ImVec4 clear_color)
+{
+	app->m_context.end_frame(clear_color);
+}
+
+void request_quit_app_glfw_vulkan(imgui_app_fw::app_backend* app)
+{
+	app->m_context.request_quit();
+}
+
+void set_window_title_app_glfw_vulkan(imgui_app_fw::app_backend* app, const char* title)
+{
+	app->m_context.set_window_title(title);
+}
+
+ImGuiContext* get_context_app_glfw_vulkan(imgui_app_fw::app_backend* app)
+{
+	return app->m_context.m_context;
+}
+
 FG::IFrameGraph* imgui_app_fw::get_framegraph_instance()
 {
 	assert(ImGui::GetMainViewport() && ImGui::GetMainViewport()->RendererUserData);
 	return platform_renderer_data::m_shared.m_frame_graph.get();
 }
+
+ImTextureID imgui_app_fw::register_texture(FG::RawImageID image)
+{
+	return platform_renderer_data::m_shared.m_imgui_renderer.register_texture(image);
+}
+
+void imgui_app_fw::unregister_texture(ImTextureID texture)
+{
+	platform_renderer_data::m_shared.m_imgui_renderer.unregister_texture(texture);
+}
+
+void imgui_app_fw::cache_window(const char* name, bool enabled)
+{
+	auto&						names = platform_renderer_data::m_shared.m_cached_windows;
+	std::lock_guard<std::mutex> lock(names.m_mutex);
+	if (enabled)
+	{
+		names.m_ids.insert(ImHashStr(name));
+	}
+	else
+	{
+		names.m_ids.erase(ImHashStr(name));
+	}
+	names.m_any = !names.m_ids.empty();
+}
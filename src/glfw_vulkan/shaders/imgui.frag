@@ -0,0 +1,29 @@
+#version 450 core
+// See imgui.vert for the defines
+
+#if BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+
+layout(location = 0) out vec4 out_Color0;
+
+#if BINDLESS
+layout(set=0, binding=0) uniform sampler2D sTextures[MAX_TEXTURES];
+layout(location = 2) flat in uint TexIndex;
+#else
+layout(set=0, binding=0) uniform sampler2D sTexture;
+#endif
+
+layout(location = 0) in struct{
+	vec4 Color;
+	vec2 UV;
+} In;
+
+void main()
+{
+#if BINDLESS
+	out_Color0 = In.Color * texture(sTextures[nonuniformEXT(TexIndex)], In.UV.st);
+#else
+	out_Color0 = In.Color * texture(sTexture, In.UV.st);
+#endif
+}
@@ -0,0 +1,42 @@
+#version 450 core
+// PUSH_CONSTANTS, BINDLESS and MAX_TEXTURES are defined by imgui_renderer::create_pipeline() at runtime, or by the
+// SPIR-V build step in CMakeLists.txt
+
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec2 aUV;
+layout(location = 2) in vec4 aColor;
+
+#if PUSH_CONSTANTS
+layout(push_constant) uniform uPushConstant {
+#else
+layout(set=0, binding=1, std140) uniform uPushConstant {
+#endif
+	vec2 uScale;
+	vec2 uTranslate;
+#if BINDLESS
+	uint uTexture;
+#endif
+} pc;
+
+out gl_PerVertex{
+	vec4 gl_Position;
+};
+
+layout(location = 0) out struct{
+	vec4 Color;
+	vec2 UV;
+} Out;
+
+#if BINDLESS
+layout(location = 2) flat out uint TexIndex;
+#endif
+
+void main()
+{
+	Out.Color = aColor;
+	Out.UV = aUV;
+#if BINDLESS
+	TexIndex = pc.uTexture;
+#endif
+	gl_Position = vec4(aPos*pc.uScale+pc.uTranslate, 0, 1);
+}
@@ -0,0 +1,344 @@
+// dear imgui: CPU renderer used by the headless platform
+// Rasterizes ImDrawData into an ImU32 framebuffer with the same blend state as the GPU backends (SrcAlpha, OneMinusSrcAlpha on all channels).
+// Axis-aligned quads (rectangles and glyphs, which are the bulk of a typical frame) take a scanline fast path; everything else goes through
+// a generic edge-function triangle rasterizer with a top-left fill rule.
+
+#include "imgui.h"
+#include "imgui_impl_softraster.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	struct raster_vertex
+	{
+		float m_x;
+		float m_y;
+		float m_u;
+		float m_v;
+		ImU32 m_col;
+	};
+
+	struct raster_clip
+	{
+		int m_x0;
+		int m_y0;
+		int m_x1;
+		int m_y1;
+	};
+
+	inline ImU32 channel(ImU32 c, int shift)
+	{
+		return (c >> shift) & 0xFF;
+	}
+
+	inline ImU32 mul8(ImU32 a, ImU32 b)
+	{
+		ImU32 t = a * b + 128;
+		return (t + (t >> 8)) >> 8;
+	}
+
+	inline ImU32 modulate(ImU32 a, ImU32 b)
+	{
+		if (b == IM_COL32_WHITE)
+		{
+			return a;
+		}
+
+		return (mul8(channel(a, IM_COL32_R_SHIFT), channel(b, IM_COL32_R_SHIFT)) << IM_COL32_R_SHIFT) |
+			   (mul8(channel(a, IM_COL32_G_SHIFT), channel(b, IM_COL32_G_SHIFT)) << IM_COL32_G_SHIFT) |
+			   (mul8(channel(a, IM_COL32_B_SHIFT), channel(b, IM_COL32_B_SHIFT)) << IM_COL32_B_SHIFT) |
+			   (mul8(channel(a, IM_COL32_A_SHIFT), channel(b, IM_COL32_A_SHIFT)) << IM_COL32_A_SHIFT);
+	}
+
+	inline void blend(ImU32& dst, ImU32 src)
+	{
+		const ImU32 sa = channel(src, IM_COL32_A_SHIFT);
+		if (sa == 0)
+		{
+			return;
+		}
+
+		if (sa == 255)
+		{
+			dst = src;
+			return;
+		}
+
+		const ImU32 da = 255 - sa;
+		const ImU32 d  = dst;
+
+		dst = ((mul8(channel(src, IM_COL32_R_SHIFT), sa) + mul8(channel(d, IM_COL32_R_SHIFT), da)) << IM_COL32_R_SHIFT) |
+			  ((mul8(channel(src, IM_COL32_G_SHIFT), sa) + mul8(channel(d, IM_COL32_G_SHIFT), da)) << IM_COL32_G_SHIFT) |
+			  ((mul8(channel(src, IM_COL32_B_SHIFT), sa) + mul8(channel(d, IM_COL32_B_SHIFT), da)) << IM_COL32_B_SHIFT) |
+			  ((mul8(sa, sa) + mul8(channel(d, IM_COL32_A_SHIFT), da)) << IM_COL32_A_SHIFT);
+	}
+
+	inline ImU32 sample(const softraster_texture* tex, float u, float v)
+	{
+		if (tex == nullptr || tex->m_pixels == nullptr)
+		{
+			return IM_COL32_WHITE;
+		}
+
+		int x = std::clamp(int(u * tex->m_width), 0, tex->m_width - 1);
+		int y = std::clamp(int(v * tex->m_height), 0, tex->m_height - 1);
+		return tex->m_pixels[y * tex->m_width + x];
+	}
+
+	inline ImU32 lerp_color(ImU32 c0, ImU32 c1, ImU32 c2, float b0, float b1, float b2)
+	{
+		auto mix = [&](int shift) -> ImU32 {
+			float c = channel(c0, shift) * b0 + channel(c1, shift) * b1 + channel(c2, shift) * b2;
+			return ImU32(std::clamp(int(c + 0.5f), 0, 255)) << shift;
+		};
+		return mix(IM_COL32_R_SHIFT) | mix(IM_COL32_G_SHIFT) | mix(IM_COL32_B_SHIFT) | mix(IM_COL32_A_SHIFT);
+	}
+
+	// First and one-past-last pixel whose center lies in [lo, hi)
+	inline void pixel_span(float lo, float hi, int clip_lo, int clip_hi, int& first, int& last)
+	{
+		first = std::max(int(std::ceil(lo - 0.5f)), clip_lo);
+		last  = std::min(int(std::ceil(hi - 0.5f)), clip_hi);
+	}
+
+	bool try_raster_quad(softraster_target& target, const raster_clip& clip, const raster_vertex* q, const softraster_texture* tex)
+	{
+		// ImGui emits rectangles as (a, b, c, d) with indices (0, 1, 2), (0, 2, 3) and b = (c.x, a.y), d = (a.x, c.y)
+		if (q[0].m_y != q[1].m_y || q[1].m_x != q[2].m_x || q[2].m_y != q[3].m_y || q[3].m_x != q[0].m_x)
+		{
+			return false;
+		}
+
+		if (q[0].m_col != q[1].m_col || q[0].m_col != q[2].m_col || q[0].m_col != q[3].m_col)
+		{
+			return false;
+		}
+
+		// uv must be separable along the axes for the scanline walk to be exact
+		if (q[0].m_v != q[1].m_v || q[1].m_u != q[2].m_u || q[2].m_v != q[3].m_v || q[3].m_u != q[0].m_u)
+		{
+			return false;
+		}
+
+		const float x0 = std::min(q[0].m_x, q[2].m_x);
+		const float x1 = std::max(q[0].m_x, q[2].m_x);
+		const float y0 = std::min(q[0].m_y, q[2].m_y);
+		const float y1 = std::max(q[0].m_y, q[2].m_y);
+
+		if (x1 <= x0 || y1 <= y0)
+		{
+			return true;
+		}
+
+		const float u_at_x0 = q[0].m_x <= q[2].m_x ? q[0].m_u : q[2].m_u;
+		const float u_at_x1 = q[0].m_x <= q[2].m_x ? q[2].m_u : q[0].m_u;
+		const float v_at_y0 = q[0].m_y <= q[2].m_y ? q[0].m_v : q[2].m_v;
+		const float v_at_y1 = q[0].m_y <= q[2].m_y ? q[2].m_v : q[0].m_v;
+
+		int px0, px1, py0, py1;
+		pixel_span(x0, x1, clip.m_x0, clip.m_x1, px0, px1);
+		pixel_span(y0, y1, clip.m_y0, clip.m_y1, py0, py1);
+
+		const ImU32 col		  = q[0].m_col;
+		const bool	uniform_uv = u_at_x0 == u_at_x1 && v_at_y0 == v_at_y1;
+		const float du		   = (u_at_x1 - u_at_x0) / (x1 - x0);
+		const float dv		   = (v_at_y1 - v_at_y0) / (y1 - y0);
+
+		if (uniform_uv)
+		{
+			const ImU32 src = modulate(col, sample(tex, u_at_x0, v_at_y0));
+			if (channel(src, IM_COL32_A_SHIFT) == 0)
+			{
+				return true;
+			}
+
+			for (int y = py0; y < py1; ++y)
+			{
+				ImU32* row = target.m_pixels + size_t(y) * target.m_width;
+				for (int x = px0; x < px1; ++x)
+				{
+					blend(row[x], src);
+				}
+			}
+			return true;
+		}
+
+		for (int y = py0; y < py1; ++y)
+		{
+			ImU32*		row = target.m_pixels + size_t(y) * target.m_width;
+			const float v	= v_at_y0 + (float(y) + 0.5f - y0) * dv;
+			for (int x = px0; x < px1; ++x)
+			{
+				const float u = u_at_x0 + (float(x) + 0.5f - x0) * du;
+				blend(row[x], modulate(col, sample(tex, u, v)));
+			}
+		}
+		return true;
+	}
+
+	inline float edge(const raster_vertex& a, const raster_vertex& b, float px, float py)
+	{
+		return (b.m_x - a.m_x) * (py - a.m_y) - (b.m_y - a.m_y) * (px - a.m_x);
+	}
+
+	inline bool is_top_left(const raster_vertex& a, const raster_vertex& b)
+	{
+		const float dx = b.m_x - a.m_x;
+		const float dy = b.m_y - a.m_y;
+		return (dy == 0.0f && dx > 0.0f) || dy < 0.0f;
+	}
+
+	void raster_triangle(softraster_target& target, const raster_clip& clip, raster_vertex v0, raster_vertex v1, raster_vertex v2, const softraster_texture* tex)
+	{
+		float area = edge(v0, v1, v2.m_x, v2.m_y);
+		if (area == 0.0f)
+		{
+			return;
+		}
+
+		if (area < 0.0f)
+		{
+			std::swap(v1, v2);
+			area = -area;
+		}
+
+		int px0, px1, py0, py1;
+		pixel_span(std::min({v0.m_x, v1.m_x, v2.m_x}), std::max({v0.m_x, v1.m_x, v2.m_x}), clip.m_x0, clip.m_x1, px0, px1);
+		pixel_span(std::min({v0.m_y, v1.m_y, v2.m_y}), std::max({v0.m_y, v1.m_y, v2.m_y}), clip.m_y0, clip.m_y1, py0, py1);
+
+		if (px0 >= px1 || py0 >= py1)
+		{
+			return;
+		}
+
+		const bool	tl0			 = is_top_left(v1, v2);
+		const bool	tl1			 = is_top_left(v2, v0);
+		const bool	tl2			 = is_top_left(v0, v1);
+		const bool	uniform_col	 = v0.m_col == v1.m_col && v0.m_col == v2.m_col;
+		const bool	uniform_uv	 = v0.m_u == v1.m_u && v0.m_u == v2.m_u && v0.m_v == v1.m_v && v0.m_v == v2.m_v;
+		const ImU32 uniform_src	 = (uniform_col && uniform_uv) ? modulate(v0.m_col, sample(tex, v0.m_u, v0.m_v)) : 0;
+		const float inv_area	 = 1.0f / area;
+
+		// edge function deltas per pixel step in x
+		const float dx0 = -(v2.m_y - v1.m_y);
+		const float dx1 = -(v0.m_y - v2.m_y);
+		const float dx2 = -(v1.m_y - v0.m_y);
+
+		for (int y = py0; y < py1; ++y)
+		{
+			const float py = float(y) + 0.5f;
+			const float px = float(px0) + 0.5f;
+
+			float w0 = edge(v1, v2, px, py);
+			float w1 = edge(v2, v0, px, py);
+			float w2 = edge(v0, v1, px, py);
+
+			ImU32* row = target.m_pixels + size_t(y) * target.m_width;
+
+			for (int x = px0; x < px1; ++x, w0 += dx0, w1 += dx1, w2 += dx2)
+			{
+				const bool inside = (w0 > 0.0f || (w0 == 0.0f && tl0)) && (w1 > 0.0f || (w1 == 0.0f && tl1)) && (w2 > 0.0f || (w2 == 0.0f && tl2));
+				if (!inside)
+				{
+					continue;
+				}
+
+				if (uniform_col && uniform_uv)
+				{
+					blend(row[x], uniform_src);
+					continue;
+				}
+
+				const float b0	= w0 * inv_area;
+				const float b1	= w1 * inv_area;
+				const float b2	= w2 * inv_area;
+				const ImU32 col = uniform_col ? v0.m_col : lerp_color(v0.m_col, v1.m_col, v2.m_col, b0, b1, b2);
+				const ImU32 tex_col =
+					uniform_uv ? sample(tex, v0.m_u, v0.m_v) : sample(tex, v0.m_u * b0 + v1.m_u * b1 + v2.m_u * b2, v0.m_v * b0 + v1.m_v * b1 + v2.m_v * b2);
+
+				blend(row[x], modulate(col, tex_col));
+			}
+		}
+	}
+} // namespace
+
+void softraster_clear(softraster_target& target, ImVec4 clear_color)
+{
+	const ImU32 col = ImGui::ColorConvertFloat4ToU32(clear_color);
+	std::fill(target.m_pixels, target.m_pixels + size_t(target.m_width) * target.m_height, col);
+}
+
+void softraster_render_draw_data(softraster_target& target, ImDrawData* draw_data)
+{
+	if (target.m_pixels == nullptr || target.m_width <= 0 || target.m_height <= 0)
+	{
+		return;
+	}
+
+	const ImVec2 clip_off	= draw_data->DisplayPos;
+	const ImVec2 clip_scale = draw_data->FramebufferScale;
+
+	for (int i = 0; i < draw_data->CmdListsCount; ++i)
+	{
+		const ImDrawList* cmd_list = draw_data->CmdLists[i];
+		const ImDrawVert* vtx	   = cmd_list->VtxBuffer.Data;
+		const ImDrawIdx*  idx	   = cmd_list->IdxBuffer.Data;
+
+		auto fetch = [&](unsigned int index) -> raster_vertex {
+			const ImDrawVert& v = vtx[index];
+			return {(v.pos.x - clip_off.x) * clip_scale.x, (v.pos.y - clip_off.y) * clip_scale.y, v.uv.x, v.uv.y, v.col};
+		};
+
+		for (int j = 0; j < cmd_list->CmdBuffer.Size; ++j)
+		{
+			const ImDrawCmd& cmd = cmd_list->CmdBuffer[j];
+
+			if (cmd.UserCallback)
+			{
+				if (cmd.UserCallback != ImDrawCallback_ResetRenderState)
+				{
+					cmd.UserCallback(cmd_list, &cmd);
+				}
+				continue;
+			}
+
+			raster_clip clip;
+			clip.m_x0 = std::max(int((cmd.ClipRect.x - clip_off.x) * clip_scale.x), 0);
+			clip.m_y0 = std::max(int((cmd.ClipRect.y - clip_off.y) * clip_scale.y), 0);
+			clip.m_x1 = std::min(int((cmd.ClipRect.z - clip_off.x) * clip_scale.x), target.m_width);
+			clip.m_y1 = std::min(int((cmd.ClipRect.w - clip_off.y) * clip_scale.y), target.m_height);
+
+			if (clip.m_x0 >= clip.m_x1 || clip.m_y0 >= clip.m_y1)
+			{
+				continue;
+			}
+
+			const softraster_texture* tex	   = reinterpret_cast<const softraster_texture*>(cmd.TextureId);
+			const ImDrawIdx*		  cmd_idx  = idx + cmd.IdxOffset;
+			const unsigned int		  vtx_base = cmd.VtxOffset;
+			const unsigned int		  count	   = cmd.ElemCount;
+
+			for (unsigned int k = 0; k + 2 < count;)
+			{
+				if (k + 5 < count)
+				{
+					const unsigned int a = cmd_idx[k];
+					if (cmd_idx[k + 1] == a + 1 && cmd_idx[k + 2] == a + 2 && cmd_idx[k + 3] == a && cmd_idx[k + 4] == a + 2 && cmd_idx[k + 5] == a + 3)
+					{
+						const raster_vertex quad[4] = {fetch(vtx_base + a), fetch(vtx_base + a + 1), fetch(vtx_base + a + 2), fetch(vtx_base + a + 3)};
+						if (try_raster_quad(target, clip, quad, tex))
+						{
+							k += 6;
+							continue;
+						}
+					}
+				}
+
+				raster_triangle(target, clip, fetch(vtx_base + cmd_idx[k]), fetch(vtx_base + cmd_idx[k + 1]), fetch(vtx_base + cmd_idx[k + 2]), tex);
+				k += 3;
+			}
+		}
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "imgui.h"
+
+#include <cstdint>
+
+// CPU rasterizer for ImDrawData.
+// Pixels are stored as ImU32 (IM_COL32 packing), which is RGBA8 in memory on little-endian hosts.
+// ImTextureID is expected to point at a softraster_texture.
+
+struct softraster_texture
+{
+	const ImU32* m_pixels = nullptr;
+	int			 m_width  = 0;
+	int			 m_height = 0;
+};
+
+struct softraster_target
+{
+	ImU32* m_pixels = nullptr;
+	int	   m_width	= 0;
+	int	   m_height = 0;
+};
+
+void softraster_clear(softraster_target& target, ImVec4 clear_color);
+void softraster_render_draw_data(softraster_target& target, ImDrawData* draw_data);
@@ -0,0 +1,333 @@
+#include "../imgui_app_fw_impl.h"
+#include "imgui_app_fw_headless.h"
+
+#include "imgui_impl_softraster.h"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+struct headless_settings
+{
+	int	  m_width	   = 1280;
+	int	  m_height	   = 800;
+	float m_delta_time = 0.0f;
+	bool  m_viewports  = false;
+
+	static inline headless_settings& instance()
+	{
+		static headless_settings self;
+		return self;
+	}
+};
+
+// Stand-in for a platform window, one per viewport while viewports are enabled
+struct headless_viewport_data
+{
+	ImVec2			   m_pos;
+	ImVec2			   m_size;
+	bool			   m_focused = false;
+	std::vector<ImU32> m_framebuffer;
+	int				   m_fb_width  = 0;
+	int				   m_fb_height = 0;
+};
+
+struct headless_context
+{
+	using clock = std::chrono::steady_clock;
+
+	ImGuiContext*	   m_context = nullptr;
+	clock::time_point  m_time;
+	bool			   m_first_frame = true;
+	bool			   m_quit		 = false;
+	std::vector<ImU32> m_framebuffer;
+	int				   m_fb_width  = 0;
+	int				   m_fb_height = 0;
+	softraster_texture m_font_texture;
+
+	~headless_context()
+	{
+		if (m_context)
+		{
+			ImGui::DestroyContext(m_context);
+			m_context = nullptr;
+		}
+	}
+
+	static bool rasterize(std::vector<ImU32>& framebuffer, int& width, int& height, ImDrawData* draw_data, ImVec4 clear_color)
+	{
+		const int fb_width	= int(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+		const int fb_height = int(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+
+		if (fb_width <= 0 || fb_height <= 0)
+		{
+			return false;
+		}
+
+		if (fb_width != width || fb_height != height)
+		{
+			width  = fb_width;
+			height = fb_height;
+			framebuffer.resize(size_t(fb_width) * fb_height);
+		}
+
+		softraster_target target{framebuffer.data(), width, height};
+		softraster_clear(target, clear_color);
+		softraster_render_draw_data(target, draw_data);
+		return true;
+	}
+
+	static headless_viewport_data* get_viewport_data(ImGuiViewport* viewport)
+	{
+		return (headless_viewport_data*)viewport->PlatformUserData;
+	}
+
+	void init_viewports()
+	{
+		ImGuiIO& io = ImGui::GetIO();
+		io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+		io.BackendFlags |= ImGuiBackendFlags_PlatformHasViewports;
+		io.BackendFlags |= ImGuiBackendFlags_RendererHasViewports;
+
+		ImGuiPlatformIO& platform_io = ImGui::GetPlatformIO();
+
+		// A single monitor large enough to hold every viewport the workload creates
+		ImGuiPlatformMonitor monitor;
+		monitor.MainPos = monitor.WorkPos = ImVec2(0.0f, 0.0f);
+		monitor.MainSize = monitor.WorkSize = ImVec2(16384.0f, 16384.0f);
+		platform_io.Monitors.resize(0);
+		platform_io.Monitors.push_back(monitor);
+
+		platform_io.Platform_CreateWindow = [](ImGuiViewport* viewport) -> void {
+			headless_viewport_data* data = IM_NEW(headless_viewport_data)();
+			data->m_pos					 = viewport->Pos;
+			data->m_size				 = viewport->Size;
+			viewport->PlatformUserData	 = data;
+			viewport->PlatformHandle	 = data;
+		};
+
+		platform_io.Platform_DestroyWindow = [](ImGuiViewport* viewport) -> void {
+			if (headless_viewport_data* data = get_viewport_data(viewport))
+			{
+				IM_DELETE(data);
+			}
+			viewport->PlatformUserData = viewport->PlatformHandle = nullptr;
+		};
+
+		platform_io.Platform_ShowWindow = [](ImGuiViewport*) -> void {};
+
+		platform_io.Platform_SetWindowPos = [](ImGuiViewport* viewport, ImVec2 pos) -> void {
+			get_viewport_data(viewport)->m_pos = pos;
+		};
+
+		platform_io.Platform_GetWindowPos = [](ImGuiViewport* viewport) -> ImVec2 {
+			return get_viewport_data(viewport)->m_pos;
+		};
+
+		platform_io.Platform_SetWindowSize = [](ImGuiViewport* viewport, ImVec2 size) -> void {
+			get_viewport_data(viewport)->m_size = size;
+		};
+
+		platform_io.Platform_GetWindowSize = [](ImGuiViewport* viewport) -> ImVec2 {
+			return get_viewport_data(viewport)->m_size;
+		};
+
+		platform_io.Platform_SetWindowFocus = [](ImGuiViewport* viewport) -> void {
+			ImGuiPlatformIO& platform_io = ImGui::GetPlatformIO();
+			for (int n = 0; n < platform_io.Viewports.Size; n++)
+			{
+				if (headless_viewport_data* data = get_viewport_data(platform_io.Viewports[n]))
+				{
+					data->m_focused = platform_io.Viewports[n] == viewport;
+				}
+			}
+		};
+
+		platform_io.Platform_GetWindowFocus = [](ImGuiViewport* viewport) -> bool {
+			return get_viewport_data(viewport)->m_focused;
+		};
+
+		platform_io.Platform_GetWindowMinimized = [](ImGuiViewport*) -> bool {
+			return false;
+		};
+
+		platform_io.Platform_SetWindowTitle = [](ImGuiViewport*, const char*) -> void {};
+
+		platform_io.Renderer_RenderWindow = [](ImGuiViewport* viewport, void*) -> void {
+			headless_viewport_data* data = get_viewport_data(viewport);
+			rasterize(data->m_framebuffer, data->m_fb_width, data->m_fb_height, viewport->DrawData, ImVec4(0.0f, 0.0f, 0.0f, 1.0f));
+		};
+
+		// The main viewport gets the same bookkeeping, its pixels stay in headless_context::m_framebuffer
+		ImGuiViewport*			main_viewport = ImGui::GetMainViewport();
+		headless_viewport_data* data		  = IM_NEW(headless_viewport_data)();
+		data->m_size						  = io.DisplaySize;
+		data->m_focused						  = true;
+		main_viewport->PlatformUserData		  = data;
+		main_viewport->PlatformHandle		  = data;
+	}
+
+	bool init()
+	{
+		IMGUI_CHECKVERSION();
+
+		m_context	= ImGui::CreateContext();
+		ImGuiIO& io = ImGui::GetIO();
+		io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard; // Enable Keyboard Controls
+		io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;	  // Enable Docking
+		io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset; // The rasterizer honors ImDrawCmd::VtxOffset
+		io.IniFilename		   = nullptr;
+		io.BackendPlatformName = "imgui_app_fw_headless";
+		io.BackendRendererName = "imgui_impl_softraster";
+
+		ImGui::StyleColorsDark();
+
+		auto& settings = headless_settings::instance();
+		io.DisplaySize = ImVec2(float(settings.m_width), float(settings.m_height));
+
+		if (settings.m_viewports)
+		{
+			init_viewports();
+		}
+
+		unsigned char* pixels;
+		int			   width, height;
+		io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+		m_font_texture.m_pixels = reinterpret_cast<const ImU32*>(pixels);
+		m_font_texture.m_width	= width;
+		m_font_texture.m_height = height;
+		io.Fonts->TexID			= (ImTextureID)&m_font_texture;
+
+		return true;
+	}
+
+	bool pump_events()
+	{
+		return !m_quit;
+	}
+
+	void begin_frame()
+	{
+		ImGuiIO& io	   = ImGui::GetIO();
+		auto& settings = headless_settings::instance();
+
+		io.DisplaySize			   = ImVec2(float(settings.m_width), float(settings.m_height));
+		io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
+
+		if (headless_viewport_data* data = get_viewport_data(ImGui::GetMainViewport()))
+		{
+			data->m_size = io.DisplaySize;
+		}
+
+		const auto now = clock::now();
+		if (settings.m_delta_time > 0.0f)
+		{
+			io.DeltaTime = settings.m_delta_time;
+		}
+		else
+		{
+			io.DeltaTime = m_first_frame ? (1.0f / 60.0f) : std::max(std::chrono::duration<float>(now - m_time).count(), 1.0e-6f);
+		}
+		m_time		  = now;
+		m_first_frame = false;
+
+		ImGui::NewFrame();
+	}
+
+	void end_frame(ImVec4 clear_color)
+	{
+		{
+			imgui_app_fw::frame_stats::scoped_phase timer(imgui_app_fw::frame_stats::phase::render);
+			ImGui::Render();
+		}
+
+		ImDrawData* draw_data = imgui_app_fw::process_frame_draw_data(ImGui::GetDrawData());
+
+		const bool viewports = (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable) != 0;
+		if (viewports)
+		{
+			ImGui::UpdatePlatformWindows();
+		}
+
+		imgui_app_fw::frame_stats::scoped_phase timer(imgui_app_fw::frame_stats::phase::draw);
+
+		rasterize(m_framebuffer, m_fb_width, m_fb_height, draw_data, clear_color);
+
+		if (viewports)
+		{
+			ImGui::RenderPlatformWindowsDefault();
+		}
+	}
+
+	static inline std::unique_ptr<headless_context> instance;
+};
+
+void set_window_title_headless(const char* title)
+{
+}
+
+bool init_gui_headless()
+{
+	headless_context::instance = std::make_unique<headless_context>();
+	return headless_context::instance->init();
+}
+
+void destroy_gui_headless()
+{
+	headless_context::instance.reset();
+}
+
+bool pump_gui_headless()
+{
+	return headless_context::instance->pump_events();
+}
+
+void begin_frame_gui_headless()
+{
+	headless_context::instance->begin_frame();
+}
+
+void end_frame_gui_headless(ImVec4 clear_color)
+{
+	headless_context::instance->end_frame(clear_color);
+}
+
+void request_quit_headless()
+{
+	if (auto& ctx = headless_context::instance)
+	{
+		ctx->m_quit = true;
+	}
+}
+
+void imgui_app_fw::set_headless_display_size(int width, int height)
+{
+	headless_settings::instance().m_width  = width;
+	headless_settings::instance().m_height = height;
+}
+
+void imgui_app_fw::set_headless_viewports(bool enabled)
+{
+	headless_settings::instance().m_viewports = enabled;
+}
+
+void imgui_app_fw::set_headless_delta_time(float seconds)
+{
+	headless_settings::instance().m_delta_time = seconds;
+}
+
+imgui_app_fw::headless_framebuffer imgui_app_fw::get_headless_framebuffer()
+{
+	headless_framebuffer result;
+	if (auto& ctx = headless_context::instance)
+	{
+		result.m_pixels = ctx->m_framebuffer.data();
+		result.m_width	= ctx->m_fb_width;
+		result.m_height = ctx->m_fb_height;
+	}
+	return result;
+}
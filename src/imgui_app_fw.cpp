@@ -1,5 +1,13 @@
 #include "imgui_app_fw_impl.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <thread>
+
 namespace imgui_app_fw
 {
 	static bool init_gui_null()
@@ -28,12 +36,146 @@ namespace imgui_app_fw
 	{
 	}
 
+	static void request_quit_null()
+	{
+	}
+
+	static void wake_gui_null()
+	{
+	}
+
 	static auto init_gui_impl = init_gui_null;
 	static auto pump_gui_impl = pump_gui_null;
 	static auto begin_frame_gui_impl = begin_frame_gui_null;
 	static auto end_frame_gui_impl = end_frame_gui_null;
 	static auto destroy_gui_impl = destroy_gui_null;
 	static auto set_window_title_impl = set_window_title_null;
+	static auto request_quit_impl = request_quit_null;
+	static auto wake_gui_impl = wake_gui_null;
+
+	// Platforms that can block on their event queue provide this; the others ignore idle mode.
+	static bool (*wait_events_gui_impl)(double timeout_seconds) = nullptr;
+
+	struct idle_state
+	{
+		using clock = std::chrono::steady_clock;
+
+		static constexpr int64_t no_deadline = std::numeric_limits<int64_t>::max();
+
+		std::atomic<bool>	 m_enabled{false};
+		std::atomic<bool>	 m_redraw_requested{false};
+		std::atomic<int64_t> m_deadline{no_deadline}; // clock ticks since epoch
+		std::atomic<int>	 m_linger_frames{3};
+		int					 m_frames_remaining = 0;
+
+		static int64_t now()
+		{
+			return clock::now().time_since_epoch().count();
+		}
+
+		static int64_t from_seconds(double seconds)
+		{
+			return std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(seconds)).count();
+		}
+
+		static double to_seconds(int64_t ticks)
+		{
+			return std::chrono::duration<double>(clock::duration(ticks)).count();
+		}
+
+		void wake()
+		{
+			m_frames_remaining = m_linger_frames;
+		}
+
+		bool consume_deadline()
+		{
+			int64_t deadline = m_deadline.load();
+			if (deadline != no_deadline && deadline <= now())
+			{
+				// a later deadline may have been requested meanwhile, only clear the one that fired
+				m_deadline.compare_exchange_strong(deadline, no_deadline);
+				return true;
+			}
+			return false;
+		}
+	};
+
+	static idle_state g_idle;
+
+	// Paces end_frame(). Sleeps overshoot by anything from microseconds to a scheduler tick, so the wait sleeps in 1 ms
+	// steps only while the time left exceeds the mean plus one deviation of the overshoot seen so far, then spins.
+	struct frame_limiter
+	{
+		using clock = std::chrono::steady_clock;
+
+		std::atomic<int64_t> m_period{0}; // clock ticks, 0 when disabled
+		clock::time_point	 m_next;
+		double				 m_sleep_mean	  = 1e-3; // seconds a 1 ms sleep actually takes, Welford's running mean
+		double				 m_sleep_m2		  = 0.0;
+		int64_t				 m_sleep_samples = 1;
+
+		double sleep_estimate() const
+		{
+			return m_sleep_mean + std::sqrt(m_sleep_m2 / double(m_sleep_samples));
+		}
+
+		void sleep_1ms()
+		{
+			const clock::time_point start = clock::now();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			const double observed = std::chrono::duration<double>(clock::now() - start).count();
+
+			// outliers such as a preempted thread would otherwise inflate the estimate for good
+			if (m_sleep_samples < 1000 || observed < m_sleep_mean * 4.0)
+			{
+				++m_sleep_samples;
+				const double delta = observed - m_sleep_mean;
+				m_sleep_mean += delta / double(m_sleep_samples);
+				m_sleep_m2 += delta * (observed - m_sleep_mean);
+			}
+		}
+
+		void wait()
+		{
+			const clock::duration period{m_period.load()};
+			if (period.count() <= 0)
+			{
+				m_next = clock::time_point{};
+				return;
+			}
+
+			// The first frame, or one more than a period late: start the schedule over rather than rushing to catch up
+			clock::time_point now = clock::now();
+			if (m_next == clock::time_point{} || now > m_next + period)
+			{
+				m_next = now + period;
+				return;
+			}
+
+			while (std::chrono::duration<double>(m_next - now).count() > sleep_estimate())
+			{
+				sleep_1ms();
+				now = clock::now();
+			}
+
+			while (clock::now() < m_next)
+			{
+				std::this_thread::yield();
+			}
+
+			m_next += period;
+		}
+	};
+
+	static frame_limiter g_frame_limiter;
+
+	static bool g_threaded_rendering = false;
+	static bool g_skip_unchanged_frames = true;
+	static bool g_geometry_cache = true;
+	static int g_frames_in_flight = 3;
+	static present_mode g_present_mode = present_mode::fifo;
+	static int g_max_queued_frames = 1;
 
 	bool select_platform(platform p)
 	{
@@ -70,6 +212,22 @@ namespace imgui_app_fw
 			end_frame_gui_impl = end_frame_gui_glfw_vulkan;
 			destroy_gui_impl = destroy_gui_glfw_vulkan;
 			set_window_title_impl = set_window_title_glfw_vulkan;
+			request_quit_impl = request_quit_glfw_vulkan;
+			wake_gui_impl = wake_gui_glfw_vulkan;
+			wait_events_gui_impl = wait_events_gui_glfw_vulkan;
+			return true;
+		}
+#endif
+#if IMGUI_APP_HEADLESS
+		if (p == platform::headless)
+		{
+			init_gui_impl = init_gui_headless;
+			pump_gui_impl = pump_gui_headless;
+			begin_frame_gui_impl = begin_frame_gui_headless;
+			end_frame_gui_impl = end_frame_gui_headless;
+			destroy_gui_impl = destroy_gui_headless;
+			set_window_title_impl = set_window_title_headless;
+			request_quit_impl = request_quit_headless;
 			return true;
 		}
 #endif
@@ -78,22 +236,184 @@ namespace imgui_app_fw
 
 	bool init()
 	{
-		return init_gui_impl();
+		startup::begin();
+		memory::install();
+
+		bool result;
+		{
+			startup::scoped_step step("init");
+			result = init_gui_impl();
+		}
+
+		startup::end_init();
+		return result;
 	}
 
 	bool pump()
 	{
-		return pump_gui_impl();
+		if (!g_idle.m_enabled || wait_events_gui_impl == nullptr)
+		{
+			frame_stats::scoped_phase timer(frame_stats::phase::pump);
+			return pump_gui_impl();
+		}
+
+		// Keep ImGui animating while something is being interacted with
+		if (ImGui::GetCurrentContext() && ImGui::IsAnyItemActive())
+		{
+			g_idle.wake();
+		}
+
+		if (g_idle.m_redraw_requested.exchange(false) || g_idle.consume_deadline())
+		{
+			g_idle.wake();
+		}
+
+		if (g_idle.m_frames_remaining > 0)
+		{
+			--g_idle.m_frames_remaining;
+			frame_stats::scoped_phase timer(frame_stats::phase::pump);
+			return pump_gui_impl();
+		}
+
+		// Nothing pending: block until input, a posted wake-up or the next deadline
+		const int64_t deadline = g_idle.m_deadline;
+		const double  timeout  = deadline == idle_state::no_deadline ? -1.0 : std::max(idle_state::to_seconds(deadline - idle_state::now()), 0.0);
+
+		{
+			frame_stats::scoped_phase timer(frame_stats::phase::idle);
+			if (!wait_events_gui_impl(timeout))
+			{
+				return false;
+			}
+		}
+
+		g_idle.consume_deadline();
+		g_idle.m_redraw_requested = false;
+		g_idle.wake();
+		--g_idle.m_frames_remaining;
+		return true;
+	}
+
+	void set_idle_mode(bool enabled, int linger_frames)
+	{
+		g_idle.m_linger_frames = std::max(linger_frames, 1);
+		g_idle.m_enabled	   = enabled;
+		g_idle.wake();
+	}
+
+	void request_redraw()
+	{
+		g_idle.m_redraw_requested = true;
+		wake_gui_impl();
+	}
+
+	void request_redraw_at(double seconds_from_now)
+	{
+		const int64_t target   = idle_state::now() + idle_state::from_seconds(std::max(seconds_from_now, 0.0));
+		int64_t		  expected = g_idle.m_deadline;
+
+		// keep the earliest pending deadline
+		while (target < expected && !g_idle.m_deadline.compare_exchange_weak(expected, target))
+		{
+		}
+		wake_gui_impl();
+	}
+
+	void notify_activity()
+	{
+		g_idle.wake();
+	}
+
+	void set_threaded_rendering(bool enabled)
+	{
+		g_threaded_rendering = enabled;
+	}
+
+	bool threaded_rendering_requested()
+	{
+		return g_threaded_rendering;
+	}
+
+	void set_skip_unchanged_frames(bool enabled)
+	{
+		g_skip_unchanged_frames = enabled;
+	}
+
+	bool skip_unchanged_frames_enabled()
+	{
+		return g_skip_unchanged_frames;
+	}
+
+	void set_geometry_cache(bool enabled)
+	{
+		g_geometry_cache = enabled;
 	}
 
+	bool geometry_cache_enabled()
+	{
+		return g_geometry_cache;
+	}
+
+	void set_frames_in_flight(int count)
+	{
+		g_frames_in_flight = std::clamp(count, 1, 8);
+	}
+
+	int frames_in_flight_requested()
+	{
+		return g_frames_in_flight;
+	}
+
+	void set_present_mode(present_mode mode)
+	{
+		g_present_mode = mode;
+	}
+
+	present_mode present_mode_requested()
+	{
+		return g_present_mode;
+	}
+
+	void set_max_queued_frames(int count)
+	{
+		g_max_queued_frames = std::clamp(count, 1, 4);
+	}
+
+	int max_queued_frames_requested()
+	{
+		return g_max_queued_frames;
+	}
+
+	void set_frame_rate_limit(double frames_per_second)
+	{
+		g_frame_limiter.m_period = frames_per_second > 0.0 ? idle_state::from_seconds(1.0 / frames_per_second) : 0;
+	}
+
+	static frame_stats::scoped_phase::clock::time_point g_ui_build_start;
+
 	void begin_frame()
 	{
-		begin_frame_gui_impl();
+		{
+			frame_stats::scoped_phase timer(frame_stats::phase::new_frame);
+			begin_frame_gui_impl();
+		}
+		g_ui_build_start = frame_stats::scoped_phase::clock::now();
+		frame_stats::exchange_current_phase(frame_stats::phase::ui_build);
 	}
 
 	void end_frame(ImVec4 clear_color)
 	{
+		frame_stats::add(
+			frame_stats::phase::ui_build, std::chrono::duration_cast<std::chrono::nanoseconds>(frame_stats::scoped_phase::clock::now() - g_ui_build_start).count());
+
+		frame_stats::exchange_current_phase(frame_stats::phase::frame);
+
 		end_frame_gui_impl(clear_color);
+		frame_stats::commit_frame();
+		memory::commit_frame();
+		startup::first_frame_done();
+
+		g_frame_limiter.wait();
 	}
 
 	void destroy()
@@ -105,5 +425,10 @@ namespace imgui_app_fw
 	{
 		set_window_title_impl(title);
 	}
+
+	void request_quit()
+	{
+		request_quit_impl();
+	}
 }
 
@@ -0,0 +1,88 @@
+#include "imgui_app_fw_impl.h"
+
+namespace imgui_app_fw
+{
+	app::~app()
+	{
+		destroy();
+	}
+
+	bool app::init(const char* title, int width, int height)
+	{
+#if IMGUI_APP_GLFW_VULKAN
+		if (m_backend)
+		{
+			return false;
+		}
+
+		memory::install();
+		m_backend = create_app_glfw_vulkan(title, width, height);
+		return m_backend != nullptr;
+#else
+		return false;
+#endif
+	}
+
+	bool app::pump()
+	{
+#if IMGUI_APP_GLFW_VULKAN
+		return m_backend && pump_app_glfw_vulkan(m_backend);
+#else
+		return false;
+#endif
+	}
+
+	void app::begin_frame()
+	{
+#if IMGUI_APP_GLFW_VULKAN
+		begin_frame_app_glfw_vulkan(m_backend);
+#endif
+	}
+
+	void app::end_frame(ImVec4 clear_color)
+	{
+#if IMGUI_APP_GLFW_VULKAN
+		end_frame_app_glfw_vulkan(m_backend, clear_color);
+#endif
+	}
+
+	void app::destroy()
+	{
+#if IMGUI_APP_GLFW_VULKAN
+		if (m_backend)
+		{
+			destroy_app_glfw_vulkan(m_backend);
+			m_backend = nullptr;
+		}
+#endif
+	}
+
+	void app::request_quit()
+	{
+#if IMGUI_APP_GLFW_VULKAN
+		if (m_backend)
+		{
+			request_quit_app_glfw_vulkan(m_backend);
+		}
+#endif
+	}
+
+	void app::set_window_title(const char* title)
+	{
+#if IMGUI_APP_GLFW_VULKAN
+		if (m_backend)
+		{
+			set_window_title_app_glfw_vulkan(m_backend, title);
+		}
+#endif
+	}
+
+	ImGuiContext* app::context() const
+	{
+#if IMGUI_APP_GLFW_VULKAN
+		return m_backend ? get_context_app_glfw_vulkan(m_backend) : nullptr;
+#else
+		return nullptr;
+#endif
+	}
+}
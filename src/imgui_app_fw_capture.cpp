@@ -0,0 +1,581 @@
+#include "imgui_app_fw_impl.h"
+#include "imgui_app_fw_capture.h"
+
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace imgui_app_fw
+{
+	namespace capture
+	{
+		// File layout, native endianness, every section 8-byte aligned so a mapped file can be read in place:
+		//   file_header
+		//   per frame: frame_header, list_header[list_count], then per list cmd_record[cmd_count], ImDrawVert[vtx_count], ImDrawIdx[idx_count]
+		//   uint64_t frame_offsets[frame_count]
+		static constexpr char	  file_magic[8] = {'I', 'M', 'D', 'R', 'A', 'W', 'C', 'P'};
+		static constexpr uint32_t file_version	= 1;
+
+		struct file_header
+		{
+			char	 m_magic[8];
+			uint32_t m_version;
+			uint32_t m_vertex_size;
+			uint32_t m_index_size;
+			uint32_t m_frame_count;
+			uint64_t m_frame_table_offset;
+		};
+
+		struct frame_header
+		{
+			float	 m_display_pos[2];
+			float	 m_display_size[2];
+			float	 m_framebuffer_scale[2];
+			uint64_t m_font_texture;
+			uint32_t m_list_count;
+			uint32_t m_total_vtx_count;
+			uint32_t m_total_idx_count;
+			uint32_t m_reserved;
+		};
+
+		struct list_header
+		{
+			uint32_t m_cmd_count;
+			uint32_t m_vtx_count;
+			uint32_t m_idx_count;
+			uint32_t m_flags;
+		};
+
+		enum cmd_flags : uint32_t
+		{
+			cmd_reset_render_state = 1,
+		};
+
+		struct cmd_record
+		{
+			float	 m_clip_rect[4];
+			uint64_t m_texture;
+			uint32_t m_vtx_offset;
+			uint32_t m_idx_offset;
+			uint32_t m_elem_count;
+			uint32_t m_flags;
+		};
+
+		static_assert(sizeof(file_header) == 32, "capture file layout changed");
+		static_assert(sizeof(frame_header) == 48, "capture file layout changed");
+		static_assert(sizeof(list_header) == 16, "capture file layout changed");
+		static_assert(sizeof(cmd_record) == 40, "capture file layout changed");
+
+		static size_t align8(size_t size)
+		{
+			return (size + 7) & ~size_t(7);
+		}
+
+		static uint64_t texture_to_u64(ImTextureID id)
+		{
+			uint64_t result = 0;
+			std::memcpy(&result, &id, sizeof(id) < sizeof(result) ? sizeof(id) : sizeof(result));
+			return result;
+		}
+
+		struct recorder
+		{
+			std::FILE*			  m_file   = nullptr;
+			uint64_t			  m_offset = 0;
+			std::vector<uint64_t> m_frame_offsets;
+			std::vector<uint8_t>  m_buffer;
+
+			~recorder()
+			{
+				close();
+			}
+
+			bool open(const char* path)
+			{
+				close();
+
+				m_file = std::fopen(path, "wb");
+				if (m_file == nullptr)
+				{
+					return false;
+				}
+
+				// rewritten with the real frame count and table offset by close()
+				file_header header = make_header(0, 0);
+				std::fwrite(&header, sizeof(header), 1, m_file);
+				m_offset = sizeof(header);
+				m_frame_offsets.clear();
+				return true;
+			}
+
+			void close()
+			{
+				if (m_file == nullptr)
+				{
+					return;
+				}
+
+				const uint64_t table_offset = m_offset;
+				if (!m_frame_offsets.empty())
+				{
+					std::fwrite(m_frame_offsets.data(), sizeof(uint64_t), m_frame_offsets.size(), m_file);
+				}
+
+				file_header header = make_header(uint32_t(m_frame_offsets.size()), table_offset);
+				std::fseek(m_file, 0, SEEK_SET);
+				std::fwrite(&header, sizeof(header), 1, m_file);
+				std::fclose(m_file);
+				m_file = nullptr;
+			}
+
+			static file_header make_header(uint32_t frame_count, uint64_t table_offset)
+			{
+				file_header header;
+				std::memcpy(header.m_magic, file_magic, sizeof(file_magic));
+				header.m_version			= file_version;
+				header.m_vertex_size		= uint32_t(sizeof(ImDrawVert));
+				header.m_index_size			= uint32_t(sizeof(ImDrawIdx));
+				header.m_frame_count		= frame_count;
+				header.m_frame_table_offset = table_offset;
+				return header;
+			}
+
+			template<typename T>
+			T* append(size_t count)
+			{
+				const size_t offset = m_buffer.size();
+				m_buffer.resize(offset + align8(sizeof(T) * count));
+				return reinterpret_cast<T*>(m_buffer.data() + offset);
+			}
+
+			void write_frame(const ImDrawData* draw_data)
+			{
+				m_buffer.clear();
+
+				{
+					frame_header* frame = append<frame_header>(1);
+					std::memset(frame, 0, sizeof(*frame));
+					frame->m_display_pos[0]		  = draw_data->DisplayPos.x;
+					frame->m_display_pos[1]		  = draw_data->DisplayPos.y;
+					frame->m_display_size[0]	  = draw_data->DisplaySize.x;
+					frame->m_display_size[1]	  = draw_data->DisplaySize.y;
+					frame->m_framebuffer_scale[0] = draw_data->FramebufferScale.x;
+					frame->m_framebuffer_scale[1] = draw_data->FramebufferScale.y;
+					frame->m_font_texture		  = ImGui::GetCurrentContext() ? texture_to_u64(ImGui::GetIO().Fonts->TexID) : 0;
+					frame->m_list_count			  = uint32_t(draw_data->CmdListsCount);
+				}
+
+				const size_t lists_offset = m_buffer.size();
+				append<list_header>(draw_data->CmdListsCount);
+
+				uint32_t total_vtx = 0;
+				uint32_t total_idx = 0;
+
+				for (int i = 0; i < draw_data->CmdListsCount; ++i)
+				{
+					const ImDrawList* cmd_list = draw_data->CmdLists[i];
+
+					uint32_t cmd_count = 0;
+					for (const ImDrawCmd& cmd : cmd_list->CmdBuffer)
+					{
+						if (cmd.UserCallback == nullptr || cmd.UserCallback == ImDrawCallback_ResetRenderState)
+						{
+							++cmd_count;
+						}
+					}
+
+					cmd_record* cmds = append<cmd_record>(cmd_count);
+					for (const ImDrawCmd& cmd : cmd_list->CmdBuffer)
+					{
+						if (cmd.UserCallback != nullptr && cmd.UserCallback != ImDrawCallback_ResetRenderState)
+						{
+							continue;
+						}
+
+						cmd_record& rec	   = *cmds++;
+						rec.m_clip_rect[0] = cmd.ClipRect.x;
+						rec.m_clip_rect[1] = cmd.ClipRect.y;
+						rec.m_clip_rect[2] = cmd.ClipRect.z;
+						rec.m_clip_rect[3] = cmd.ClipRect.w;
+						rec.m_texture	   = texture_to_u64(cmd.TextureId);
+						rec.m_vtx_offset   = cmd.VtxOffset;
+						rec.m_idx_offset   = cmd.IdxOffset;
+						rec.m_elem_count   = cmd.ElemCount;
+						rec.m_flags		   = cmd.UserCallback ? cmd_reset_render_state : 0;
+					}
+
+					std::memcpy(append<ImDrawVert>(cmd_list->VtxBuffer.Size), cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.size_in_bytes());
+					std::memcpy(append<ImDrawIdx>(cmd_list->IdxBuffer.Size), cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.size_in_bytes());
+
+					// the buffer may have moved while appending
+					list_header& list = reinterpret_cast<list_header*>(m_buffer.data() + lists_offset)[i];
+					list.m_cmd_count  = cmd_count;
+					list.m_vtx_count  = uint32_t(cmd_list->VtxBuffer.Size);
+					list.m_idx_count  = uint32_t(cmd_list->IdxBuffer.Size);
+					list.m_flags	  = uint32_t(cmd_list->Flags);
+
+					total_vtx += list.m_vtx_count;
+					total_idx += list.m_idx_count;
+				}
+
+				frame_header* frame		 = reinterpret_cast<frame_header*>(m_buffer.data());
+				frame->m_total_vtx_count = total_vtx;
+				frame->m_total_idx_count = total_idx;
+
+				m_frame_offsets.push_back(m_offset);
+				std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+				m_offset += m_buffer.size();
+			}
+		};
+
+		struct mapped_file
+		{
+			const uint8_t* m_data = nullptr;
+			size_t		   m_size = 0;
+#ifdef _WIN32
+			HANDLE m_file	 = INVALID_HANDLE_VALUE;
+			HANDLE m_mapping = nullptr;
+#endif
+
+			~mapped_file()
+			{
+				close();
+			}
+
+			bool open(const char* path)
+			{
+				close();
+#ifdef _WIN32
+				m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+				if (m_file == INVALID_HANDLE_VALUE)
+				{
+					return false;
+				}
+
+				LARGE_INTEGER size;
+				if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+				{
+					close();
+					return false;
+				}
+
+				m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (m_mapping == nullptr)
+				{
+					close();
+					return false;
+				}
+
+				m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+				m_size = size_t(size.QuadPart);
+#else
+				const int fd = ::open(path, O_RDONLY);
+				if (fd < 0)
+				{
+					return false;
+				}
+
+				struct stat st;
+				if (fstat(fd, &st) != 0 || st.st_size == 0)
+				{
+					::close(fd);
+					return false;
+				}
+
+				void* data = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+				::close(fd);
+
+				if (data != MAP_FAILED)
+				{
+					m_data = static_cast<const uint8_t*>(data);
+					m_size = size_t(st.st_size);
+				}
+#endif
+				if (m_data == nullptr)
+				{
+					close();
+					return false;
+				}
+				return true;
+			}
+
+			void close()
+			{
+#ifdef _WIN32
+				if (m_data)
+				{
+					UnmapViewOfFile(m_data);
+				}
+				if (m_mapping)
+				{
+					CloseHandle(m_mapping);
+				}
+				if (m_file != INVALID_HANDLE_VALUE)
+				{
+					CloseHandle(m_file);
+				}
+				m_mapping = nullptr;
+				m_file	  = INVALID_HANDLE_VALUE;
+#else
+				if (m_data)
+				{
+					munmap(const_cast<uint8_t*>(m_data), m_size);
+				}
+#endif
+				m_data = nullptr;
+				m_size = 0;
+			}
+		};
+
+		struct player
+		{
+			mapped_file		   m_file;
+			const file_header* m_header		 = nullptr;
+			const uint64_t*	   m_frame_table = nullptr;
+			draw_data_snapshot m_frame;
+			bool			   m_pending = false;
+
+			bool open(const char* path)
+			{
+				close();
+
+				if (!m_file.open(path) || m_file.m_size < sizeof(file_header))
+				{
+					close();
+					return false;
+				}
+
+				const file_header* header = reinterpret_cast<const file_header*>(m_file.m_data);
+				if (std::memcmp(header->m_magic, file_magic, sizeof(file_magic)) != 0 || header->m_version != file_version ||
+					header->m_vertex_size != sizeof(ImDrawVert) || header->m_index_size != sizeof(ImDrawIdx) ||
+					header->m_frame_table_offset > m_file.m_size || (m_file.m_size - header->m_frame_table_offset) / sizeof(uint64_t) < header->m_frame_count)
+				{
+					close();
+					return false;
+				}
+
+				m_header	  = header;
+				m_frame_table = reinterpret_cast<const uint64_t*>(m_file.m_data + header->m_frame_table_offset);
+				return true;
+			}
+
+			void close()
+			{
+				m_file.close();
+				m_header	  = nullptr;
+				m_frame_table = nullptr;
+				m_pending	  = false;
+			}
+
+			int frame_count() const
+			{
+				return m_header ? int(m_header->m_frame_count) : 0;
+			}
+
+			// Bounds-checked cursor over one frame, a truncated or corrupt file fails the decode instead of reading past the mapping
+			struct cursor
+			{
+				const uint8_t* m_pos;
+				const uint8_t* m_end;
+
+				template<typename T>
+				const T* take(size_t count)
+				{
+					const size_t size = align8(sizeof(T) * count);
+					if (size_t(m_end - m_pos) < size)
+					{
+						return nullptr;
+					}
+
+					const T* result = reinterpret_cast<const T*>(m_pos);
+					m_pos += size;
+					return result;
+				}
+			};
+
+			static bool finite(const float* values, int count)
+			{
+				for (int i = 0; i < count; ++i)
+				{
+					if (!std::isfinite(values[i]))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+
+			// Every command must read inside its list's buffers and have a finite clip rect, so a corrupt file can't drive
+			// the renderers past them
+			static bool valid_list(const list_header& list, const cmd_record* cmds, const ImDrawIdx* idx)
+			{
+				for (uint32_t j = 0; j < list.m_cmd_count; ++j)
+				{
+					const cmd_record& rec = cmds[j];
+					if (!finite(rec.m_clip_rect, 4) || uint64_t(rec.m_idx_offset) + rec.m_elem_count > list.m_idx_count || rec.m_vtx_offset > list.m_vtx_count)
+					{
+						return false;
+					}
+
+					for (uint32_t k = rec.m_idx_offset; k < rec.m_idx_offset + rec.m_elem_count; ++k)
+					{
+						if (uint64_t(idx[k]) + rec.m_vtx_offset >= list.m_vtx_count)
+						{
+							return false;
+						}
+					}
+				}
+				return true;
+			}
+
+			ImDrawData* load(int index)
+			{
+				m_pending = false;
+
+				if (index < 0 || index >= frame_count() || m_frame_table[index] >= m_header->m_frame_table_offset)
+				{
+					return nullptr;
+				}
+
+				cursor c{m_file.m_data + m_frame_table[index], m_file.m_data + m_header->m_frame_table_offset};
+
+				const frame_header* frame = c.take<frame_header>(1);
+				const list_header*	lists = frame ? c.take<list_header>(frame->m_list_count) : nullptr;
+				if (lists == nullptr || !finite(frame->m_display_pos, 2) || !finite(frame->m_display_size, 2) || !finite(frame->m_framebuffer_scale, 2))
+				{
+					return nullptr;
+				}
+
+				// the atlas texture id is only meaningful in the recording session, map it to the current one
+				const uint64_t	  font_texture = frame->m_font_texture;
+				const ImTextureID current_font = ImGui::GetCurrentContext() ? ImGui::GetIO().Fonts->TexID : ImTextureID{};
+
+				m_frame.resize(int(frame->m_list_count));
+				uint64_t total_vtx_count = 0;
+				uint64_t total_idx_count = 0;
+
+				for (uint32_t i = 0; i < frame->m_list_count; ++i)
+				{
+					const cmd_record* cmds = c.take<cmd_record>(lists[i].m_cmd_count);
+					const ImDrawVert* vtx  = c.take<ImDrawVert>(lists[i].m_vtx_count);
+					const ImDrawIdx*  idx  = c.take<ImDrawIdx>(lists[i].m_idx_count);
+					if (cmds == nullptr || vtx == nullptr || idx == nullptr || !valid_list(lists[i], cmds, idx))
+					{
+						return nullptr;
+					}
+
+					total_vtx_count += lists[i].m_vtx_count;
+					total_idx_count += lists[i].m_idx_count;
+					if (total_vtx_count > uint64_t(INT_MAX) || total_idx_count > uint64_t(INT_MAX))
+					{
+						return nullptr;
+					}
+
+					ImDrawList* cmd_list = m_frame.m_lists[int(i)];
+					cmd_list->Flags		 = ImDrawListFlags(lists[i].m_flags);
+
+					cmd_list->CmdBuffer.resize(int(lists[i].m_cmd_count));
+					for (uint32_t j = 0; j < lists[i].m_cmd_count; ++j)
+					{
+						const cmd_record& rec = cmds[j];
+						ImDrawCmd&		  cmd = cmd_list->CmdBuffer[int(j)];
+
+						cmd					 = ImDrawCmd();
+						cmd.ClipRect		 = ImVec4(rec.m_clip_rect[0], rec.m_clip_rect[1], rec.m_clip_rect[2], rec.m_clip_rect[3]);
+						cmd.TextureId		 = rec.m_texture == font_texture ? current_font : ImTextureID{};
+						cmd.VtxOffset		 = rec.m_vtx_offset;
+						cmd.IdxOffset		 = rec.m_idx_offset;
+						cmd.ElemCount		 = rec.m_elem_count;
+						cmd.UserCallback	 = (rec.m_flags & cmd_reset_render_state) ? ImDrawCallback_ResetRenderState : nullptr;
+						cmd.UserCallbackData = nullptr;
+					}
+
+					cmd_list->VtxBuffer.resize(int(lists[i].m_vtx_count));
+					cmd_list->IdxBuffer.resize(int(lists[i].m_idx_count));
+					std::memcpy(cmd_list->VtxBuffer.Data, vtx, sizeof(ImDrawVert) * lists[i].m_vtx_count);
+					std::memcpy(cmd_list->IdxBuffer.Data, idx, sizeof(ImDrawIdx) * lists[i].m_idx_count);
+				}
+
+				ImDrawData& draw_data	   = m_frame.m_draw_data;
+				draw_data.Valid			   = true;
+				draw_data.TotalVtxCount	   = int(total_vtx_count);
+				draw_data.TotalIdxCount	   = int(total_idx_count);
+				draw_data.DisplayPos	   = ImVec2(frame->m_display_pos[0], frame->m_display_pos[1]);
+				draw_data.DisplaySize	   = ImVec2(frame->m_display_size[0], frame->m_display_size[1]);
+				draw_data.FramebufferScale = ImVec2(frame->m_framebuffer_scale[0], frame->m_framebuffer_scale[1]);
+				draw_data.OwnerViewport	   = nullptr;
+
+				m_pending = true;
+				return &draw_data;
+			}
+		};
+
+		static recorder g_recorder;
+		static player	g_player;
+
+		bool start_recording(const char* path)
+		{
+			return g_recorder.open(path);
+		}
+
+		void stop_recording()
+		{
+			g_recorder.close();
+		}
+
+		bool is_recording()
+		{
+			return g_recorder.m_file != nullptr;
+		}
+
+		bool open_replay(const char* path)
+		{
+			return g_player.open(path);
+		}
+
+		void close_replay()
+		{
+			g_player.close();
+		}
+
+		int replay_frame_count()
+		{
+			return g_player.frame_count();
+		}
+
+		ImDrawData* load_replay_frame(int index)
+		{
+			return g_player.load(index);
+		}
+	}
+
+	ImDrawData* process_frame_draw_data(ImDrawData* draw_data)
+	{
+		if (capture::g_player.m_pending)
+		{
+			capture::g_player.m_pending = false;
+			draw_data					= &capture::g_player.m_frame.m_draw_data;
+		}
+
+		if (capture::g_recorder.m_file && draw_data)
+		{
+			capture::g_recorder.write_frame(draw_data);
+		}
+
+		return draw_data;
+	}
+}
@@ -0,0 +1,213 @@
+#include "imgui_app_fw_impl.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace imgui_app_fw
+{
+	// ImVector::operator= frees before copying, this keeps the existing capacity instead
+	template<typename T>
+	static void copy_vector(ImVector<T>& dst, const ImVector<T>& src)
+	{
+		dst.resize(src.Size);
+		if (src.Size > 0)
+		{
+			std::memcpy(dst.Data, src.Data, size_t(src.size_in_bytes()));
+		}
+	}
+
+	// Multiply-xorshift over 8-byte words in four independent lanes so the multiplies overlap. Not a quality hash, only cheap
+	// enough to run over every vertex of every frame.
+	struct draw_data_hasher
+	{
+		static constexpr uint64_t prime = 0x9E3779B97F4A7C15ull;
+
+		uint64_t m_lanes[4] = {prime, prime ^ 1, prime ^ 2, prime ^ 3};
+
+		static uint64_t mix(uint64_t state, uint64_t word)
+		{
+			state = (state ^ word) * 0xFF51AFD7ED558CCDull;
+			return state ^ (state >> 32);
+		}
+
+		static uint64_t load(const uint8_t* p)
+		{
+			uint64_t word;
+			std::memcpy(&word, p, sizeof(word));
+			return word;
+		}
+
+		void add(const void* data, size_t size)
+		{
+			const uint8_t* p = static_cast<const uint8_t*>(data);
+
+			for (; size >= 32; p += 32, size -= 32)
+			{
+				m_lanes[0] = mix(m_lanes[0], load(p));
+				m_lanes[1] = mix(m_lanes[1], load(p + 8));
+				m_lanes[2] = mix(m_lanes[2], load(p + 16));
+				m_lanes[3] = mix(m_lanes[3], load(p + 24));
+			}
+
+			for (; size >= 8; p += 8, size -= 8)
+			{
+				m_lanes[0] = mix(m_lanes[0], load(p));
+			}
+
+			// the length keeps buffers that only differ in trailing zeros apart
+			uint64_t tail = 0;
+			if (size > 0)
+			{
+				std::memcpy(&tail, p, size);
+			}
+			m_lanes[1] = mix(m_lanes[1], tail ^ (uint64_t(size) << 56));
+		}
+
+		template<typename T>
+		void add_value(const T& value)
+		{
+			add(&value, sizeof(value));
+		}
+
+		uint64_t finish() const
+		{
+			return mix(mix(m_lanes[0], m_lanes[1]), mix(m_lanes[2], m_lanes[3]));
+		}
+	};
+
+	bool hash_draw_data(const ImDrawData* draw_data, uint64_t& hash)
+	{
+		draw_data_hasher hasher;
+		hasher.add_value(draw_data->DisplayPos);
+		hasher.add_value(draw_data->DisplaySize);
+		hasher.add_value(draw_data->FramebufferScale);
+		hasher.add_value(draw_data->CmdListsCount);
+
+		for (int i = 0; i < draw_data->CmdListsCount; ++i)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[i];
+
+			for (const ImDrawCmd& cmd : cmd_list->CmdBuffer)
+			{
+				// a callback may draw something different every time it runs
+				if (cmd.UserCallback && cmd.UserCallback != ImDrawCallback_ResetRenderState)
+				{
+					return false;
+				}
+
+				// field by field, the struct has padding
+				hasher.add_value(cmd.ClipRect);
+				hasher.add_value(cmd.TextureId);
+				hasher.add_value(cmd.VtxOffset);
+				hasher.add_value(cmd.IdxOffset);
+				hasher.add_value(cmd.ElemCount);
+				hasher.add_value(cmd.UserCallback != nullptr);
+			}
+
+			hasher.add(cmd_list->VtxBuffer.Data, size_t(cmd_list->VtxBuffer.size_in_bytes()));
+			hasher.add(cmd_list->IdxBuffer.Data, size_t(cmd_list->IdxBuffer.size_in_bytes()));
+		}
+
+		hash = hasher.finish();
+		return true;
+	}
+
+	uint64_t hash_draw_list_geometry(const ImDrawList& cmd_list)
+	{
+		draw_data_hasher hasher;
+		hasher.add_value(cmd_list.VtxBuffer.Size);
+		hasher.add_value(cmd_list.IdxBuffer.Size);
+		hasher.add(cmd_list.VtxBuffer.Data, size_t(cmd_list.VtxBuffer.size_in_bytes()));
+		hasher.add(cmd_list.IdxBuffer.Data, size_t(cmd_list.IdxBuffer.size_in_bytes()));
+		return hasher.finish();
+	}
+
+	uint64_t hash_draw_list_at(const ImDrawList& cmd_list, ImVec2 origin)
+	{
+		draw_data_hasher hasher;
+
+		for (const ImDrawCmd& cmd : cmd_list.CmdBuffer)
+		{
+			hasher.add_value(ImVec4(cmd.ClipRect.x - origin.x, cmd.ClipRect.y - origin.y, cmd.ClipRect.z - origin.x, cmd.ClipRect.w - origin.y));
+			hasher.add_value(cmd.TextureId);
+			hasher.add_value(cmd.VtxOffset);
+			hasher.add_value(cmd.IdxOffset);
+			hasher.add_value(cmd.ElemCount);
+		}
+
+		// translated in batches so the hasher still sees long runs
+		constexpr int batch_size = 64;
+		ImDrawVert	  batch[batch_size];
+		for (int first = 0; first < cmd_list.VtxBuffer.Size; first += batch_size)
+		{
+			const int count = std::min(batch_size, cmd_list.VtxBuffer.Size - first);
+			for (int i = 0; i < count; ++i)
+			{
+				batch[i] = cmd_list.VtxBuffer.Data[first + i];
+				batch[i].pos.x -= origin.x;
+				batch[i].pos.y -= origin.y;
+			}
+			hasher.add(batch, size_t(count) * sizeof(ImDrawVert));
+		}
+
+		hasher.add(cmd_list.IdxBuffer.Data, size_t(cmd_list.IdxBuffer.size_in_bytes()));
+		return hasher.finish();
+	}
+
+	draw_data_snapshot::~draw_data_snapshot()
+	{
+		for (ImDrawList* list : m_lists)
+		{
+			IM_DELETE(list);
+		}
+		m_lists.clear();
+	}
+
+	void draw_data_snapshot::resize(int list_count)
+	{
+		while (m_lists.Size < list_count)
+		{
+			m_lists.push_back(IM_NEW(ImDrawList)(nullptr));
+		}
+
+		m_draw_data.CmdLists	  = m_lists.Data;
+		m_draw_data.CmdListsCount = list_count;
+	}
+
+	void draw_data_snapshot::copy_from(const ImDrawData* src)
+	{
+		resize(src->CmdListsCount);
+		if (m_owner_names.size() < size_t(src->CmdListsCount))
+		{
+			m_owner_names.resize(size_t(src->CmdListsCount));
+		}
+
+		for (int i = 0; i < src->CmdListsCount; ++i)
+		{
+			const ImDrawList* src_list = src->CmdLists[i];
+			ImDrawList*		  dst_list = m_lists[i];
+
+			copy_vector(dst_list->CmdBuffer, src_list->CmdBuffer);
+			copy_vector(dst_list->IdxBuffer, src_list->IdxBuffer);
+			copy_vector(dst_list->VtxBuffer, src_list->VtxBuffer);
+			dst_list->Flags = src_list->Flags;
+
+			// ImGui reallocates a window's name when its "###" title changes, so the snapshot keeps a copy
+			if (src_list->_OwnerName)
+			{
+				m_owner_names[i].assign(src_list->_OwnerName);
+				dst_list->_OwnerName = m_owner_names[i].c_str();
+			}
+			else
+			{
+				dst_list->_OwnerName = nullptr;
+			}
+		}
+
+		// the owning viewport may be gone by the time the copy is consumed
+		m_draw_data				  = *src;
+		m_draw_data.CmdLists	  = m_lists.Data;
+		m_draw_data.OwnerViewport = nullptr;
+	}
+}
@@ -0,0 +1,236 @@
+#include "imgui_app_fw_impl.h"
+#include "imgui_app_fw_fonts.h"
+
+#include <imgui_internal.h>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace imgui_app_fw
+{
+	namespace fonts
+	{
+		struct glyph_cache
+		{
+			std::mutex m_mutex;
+
+			// Code point outside the default ranges to the update_atlas() tick it was last requested in
+			std::unordered_map<ImWchar, uint32_t> m_last_used;
+
+			// Zero terminated pairs, the default ranges followed by the requested glyphs. The GlyphRanges of every on-demand
+			// font config points here, which is how update_atlas() finds them again after m_ranges is replaced.
+			ImVector<ImWchar> m_ranges;
+
+			uint32_t	m_tick	 = 0;
+			bool		m_dirty	 = false;
+			size_t		m_budget = 0;
+			cache_state m_state;
+
+			const ImWchar* ranges()
+			{
+				if (m_ranges.empty())
+				{
+					append_default_ranges(m_ranges);
+					m_ranges.push_back(0);
+				}
+				return m_ranges.Data;
+			}
+
+			static void append_default_ranges(ImVector<ImWchar>& out)
+			{
+				// ImFontAtlas::GetGlyphRangesDefault(), which is not static in this version of ImGui
+				out.push_back(0x0020);
+				out.push_back(0x00FF);
+			}
+
+			void add(unsigned int c)
+			{
+				if (c <= 0x00FF || c > IM_UNICODE_CODEPOINT_MAX)
+				{
+					return;
+				}
+
+				auto [it, inserted] = m_last_used.try_emplace(ImWchar(c), m_tick);
+				it->second			= m_tick;
+				m_dirty				= m_dirty || inserted;
+			}
+
+			void build_ranges(ImVector<ImWchar>& out) const
+			{
+				std::vector<ImWchar> glyphs;
+				glyphs.reserve(m_last_used.size());
+				for (const auto& entry : m_last_used)
+				{
+					glyphs.push_back(entry.first);
+				}
+				std::sort(glyphs.begin(), glyphs.end());
+
+				append_default_ranges(out);
+				for (size_t i = 0; i < glyphs.size();)
+				{
+					size_t last = i;
+					while (last + 1 < glyphs.size() && glyphs[last + 1] == glyphs[last] + 1)
+					{
+						++last;
+					}
+					out.push_back(glyphs[i]);
+					out.push_back(glyphs[last]);
+					i = last + 1;
+				}
+				out.push_back(0);
+			}
+
+			// Drops the coldest quarter of the glyphs not requested since the last update, false when there are none
+			bool evict(uint32_t hot)
+			{
+				std::vector<std::pair<uint32_t, ImWchar>> cold;
+				for (const auto& entry : m_last_used)
+				{
+					if (entry.second < hot)
+					{
+						cold.emplace_back(entry.second, entry.first);
+					}
+				}
+
+				if (cold.empty())
+				{
+					return false;
+				}
+
+				const size_t count = std::max<size_t>(cold.size() / 4, 1);
+				std::nth_element(cold.begin(), cold.begin() + (count - 1), cold.end());
+				for (size_t i = 0; i < count; ++i)
+				{
+					m_last_used.erase(cold[i].second);
+				}
+				m_state.m_evictions += int(count);
+				return true;
+			}
+
+			void rebuild(ImFontAtlas* atlas)
+			{
+				ImVector<ImWchar> ranges;
+				build_ranges(ranges);
+
+				const ImWchar* previous = ranges_data();
+				for (ImFontConfig& config : atlas->ConfigData)
+				{
+					if (previous && config.GlyphRanges == previous)
+					{
+						config.GlyphRanges = ranges.Data;
+					}
+				}
+				m_ranges.swap(ranges);
+
+				atlas->ClearTexData();
+				if (atlas->ConfigData.empty())
+				{
+					atlas->AddFontDefault();
+				}
+				atlas->Build();
+
+				++m_state.m_rebuilds;
+				m_state.m_glyphs	  = int(m_last_used.size());
+				m_state.m_atlas_bytes = int64_t(atlas->TexWidth) * atlas->TexHeight * 5;
+			}
+
+			const ImWchar* ranges_data() const
+			{
+				return m_ranges.empty() ? nullptr : m_ranges.Data;
+			}
+		};
+
+		static glyph_cache g_cache;
+		static std::mutex  g_atlas_mutex;
+
+		std::mutex& atlas_mutex()
+		{
+			return g_atlas_mutex;
+		}
+
+		ImFont* add_font_from_file(const char* filename, float size_pixels, const ImFontConfig* config)
+		{
+			ImFontConfig font_config = config ? *config : ImFontConfig{};
+
+			// atlas first, update_atlas() runs with it held
+			std::lock_guard<std::mutex> atlas_lock(g_atlas_mutex);
+			std::lock_guard<std::mutex> lock(g_cache.m_mutex);
+			return ImGui::GetIO().Fonts->AddFontFromFileTTF(filename, size_pixels, &font_config, g_cache.ranges());
+		}
+
+		ImFont* add_font_from_memory(void* ttf_data, int ttf_size, float size_pixels, const ImFontConfig* config)
+		{
+			ImFontConfig font_config = config ? *config : ImFontConfig{};
+
+			std::lock_guard<std::mutex> atlas_lock(g_atlas_mutex);
+			std::lock_guard<std::mutex> lock(g_cache.m_mutex);
+			return ImGui::GetIO().Fonts->AddFontFromMemoryTTF(ttf_data, ttf_size, size_pixels, &font_config, g_cache.ranges());
+		}
+
+		void request(const char* text, const char* text_end)
+		{
+			std::lock_guard<std::mutex> lock(g_cache.m_mutex);
+			while (text_end ? (text < text_end) : *text)
+			{
+				unsigned int c	   = 0;
+				const int	 c_len = ImTextCharFromUtf8(&c, text, text_end);
+				if (c_len == 0)
+				{
+					break;
+				}
+				text += c_len;
+				g_cache.add(c);
+			}
+		}
+
+		void request_range(ImWchar first, ImWchar last)
+		{
+			std::lock_guard<std::mutex> lock(g_cache.m_mutex);
+			for (unsigned int c = first; c <= last; ++c)
+			{
+				g_cache.add(c);
+			}
+		}
+
+		void set_memory_budget(size_t bytes)
+		{
+			std::lock_guard<std::mutex> lock(g_cache.m_mutex);
+			g_cache.m_budget = bytes;
+			g_cache.m_dirty	 = true;
+		}
+
+		size_t memory_budget()
+		{
+			std::lock_guard<std::mutex> lock(g_cache.m_mutex);
+			return g_cache.m_budget;
+		}
+
+		cache_state current_state()
+		{
+			std::lock_guard<std::mutex> lock(g_cache.m_mutex);
+			return g_cache.m_state;
+		}
+
+		bool update_atlas(ImFontAtlas* atlas)
+		{
+			std::lock_guard<std::mutex> lock(g_cache.m_mutex);
+			const uint32_t				hot = g_cache.m_tick++;
+
+			if (!g_cache.m_dirty && atlas->IsBuilt())
+			{
+				return false;
+			}
+			g_cache.m_dirty = false;
+
+			g_cache.rebuild(atlas);
+			while (g_cache.m_budget != 0 && size_t(g_cache.m_state.m_atlas_bytes) > g_cache.m_budget && g_cache.evict(hot))
+			{
+				g_cache.rebuild(atlas);
+			}
+			return true;
+		}
+	}
+}
@@ -1,8 +1,127 @@
 #pragma once
 
 #include "imgui_app_fw.h"
+#include "imgui_app_fw_app.h"
+#include "imgui_app_fw_stats.h"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if IMGUI_APP_GLFW_VULKAN
 #include "imgui_app_fw_rendering.h"
+#endif
+
+
+namespace imgui_app_fw
+{
+	// Called by platform backends whenever input or window events arrive, restarts the idle linger countdown
+	void notify_activity();
+
+	// Set through set_threaded_rendering(), read by backends in init()
+	bool threaded_rendering_requested();
+	bool skip_unchanged_frames_enabled();
+	bool geometry_cache_enabled();
+	int frames_in_flight_requested();
+	present_mode present_mode_requested();
+	int max_queued_frames_requested();
+
+	// Content hash of everything that affects the rendered image. Returns false when the frame can't be compared because it
+	// contains draw callbacks.
+	bool hash_draw_data(const ImDrawData* draw_data, uint64_t& hash);
+
+	// Hash of a list's vertices and indices, everything a draw reads from the geometry buffers
+	uint64_t hash_draw_list_geometry(const ImDrawList& cmd_list);
+
+	// Hash of a list's commands and geometry with positions and clip rects taken relative to origin, so a list that moved
+	// by exactly the distance its origin moved hashes the same
+	uint64_t hash_draw_list_at(const ImDrawList& cmd_list, ImVec2 origin);
+
+	// Deep copy of an ImDrawData that can outlive the ImGui frame. Storage is kept and reused by the next copy_from().
+	struct draw_data_snapshot
+	{
+		ImDrawData				 m_draw_data;
+		ImVector<ImDrawList*>	 m_lists;
+		std::vector<std::string> m_owner_names; // of m_lists, copied by copy_from()
+
+		draw_data_snapshot() = default;
+		draw_data_snapshot(const draw_data_snapshot&) = delete;
+		draw_data_snapshot& operator=(const draw_data_snapshot&) = delete;
+		~draw_data_snapshot();
+
+		// Makes sure list_count lists exist and points m_draw_data at them
+		void resize(int list_count);
+		void copy_from(const ImDrawData* src);
+	};
+
+	// Called by backends with the main viewport's draw data right after ImGui::Render(). Appends it to the capture file
+	// when recording, and returns the frame from load_replay_frame() instead when one is pending.
+	ImDrawData* process_frame_draw_data(ImDrawData* draw_data);
 
+	namespace frame_stats
+	{
+		// Phase running on the calling thread, phase::frame outside any. Used to attribute allocations.
+		phase current_phase();
+		phase exchange_current_phase(phase p);
+
+		struct scoped_phase
+		{
+			using clock = std::chrono::steady_clock;
+
+			phase			  m_phase;
+			phase			  m_previous;
+			clock::time_point m_start;
+
+			explicit scoped_phase(phase p) : m_phase{p}, m_previous{exchange_current_phase(p)}, m_start{clock::now()} {}
+
+			~scoped_phase()
+			{
+				add(m_phase, std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - m_start).count());
+				exchange_current_phase(m_previous);
+			}
+		};
+	}
+
+	namespace startup
+	{
+		// init() opens a new timeline, which closes when first_frame_done() records the time to the first frame. Steps are
+		// only recorded while it is open, from any thread.
+		void begin();
+		void end_init();
+		void first_frame_done();
+
+		struct scoped_step
+		{
+			int m_slot;
+
+			explicit scoped_step(const char* name);
+			~scoped_step();
+
+			scoped_step(const scoped_step&) = delete;
+			scoped_step& operator=(const scoped_step&) = delete;
+		};
+	}
+
+	namespace fonts
+	{
+		// Called by backends before ImGui::NewFrame() while no context sharing the atlas is inside a frame. Rebuilds it when
+		// glyphs were requested or fonts added since the last build, and returns true when it did.
+		bool update_atlas(ImFontAtlas* atlas);
+
+		// Held by backends while they build the shared atlas or read its pixels, and by add_font_from_file() and
+		// add_font_from_memory(), whose AddFont clears them
+		std::mutex& atlas_mutex();
+	}
+
+	namespace memory
+	{
+		// Installs the pooled ImGui allocator, must run before the first ImGui context is created
+		void install();
+		void commit_frame();
+	}
+}
 
 #if IMGUI_APP_WIN32_DX11
 bool init_gui_win32_dx11();
@@ -29,5 +148,27 @@ void begin_frame_gui_glfw_vulkan();
 void end_frame_gui_glfw_vulkan(ImVec4 clear_color);
 void destroy_gui_glfw_vulkan();
 void set_window_title_glfw_vulkan(const char* title);
+void request_quit_glfw_vulkan();
+bool wait_events_gui_glfw_vulkan(double timeout_seconds);
+void wake_gui_glfw_vulkan();
+
+imgui_app_fw::app_backend* create_app_glfw_vulkan(const char* title, int width, int height);
+void destroy_app_glfw_vulkan(imgui_app_fw::app_backend* app);
+bool pump_app_glfw_vulkan(imgui_app_fw::app_backend* app);
+void begin_frame_app_glfw_vulkan(imgui_app_fw::app_backend* app);
+void end_frame_app_glfw_vulkan(imgui_app_fw::app_backend* app, ImVec4 clear_color);
+void request_quit_app_glfw_vulkan(imgui_app_fw::app_backend* app);
+void set_window_title_app_glfw_vulkan(imgui_app_fw::app_backend* app, const char* title);
+ImGuiContext* get_context_app_glfw_vulkan(imgui_app_fw::app_backend* app);
+#endif
+
+#if IMGUI_APP_HEADLESS
+bool init_gui_headless();
+bool pump_gui_headless();
+void begin_frame_gui_headless();
+void end_frame_gui_headless(ImVec4 clear_color);
+void destroy_gui_headless();
+void set_window_title_headless(const char* title);
+void request_quit_headless();
 #endif
 
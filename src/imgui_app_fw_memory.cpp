@@ -0,0 +1,248 @@
+#include "imgui_app_fw_impl.h"
+#include "imgui_app_fw_memory.h"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+
+namespace imgui_app_fw
+{
+	namespace memory
+	{
+		static constexpr int	  phase_count = int(frame_stats::phase::count);
+		static constexpr size_t	  min_block	  = 16;
+		static constexpr int	  class_count = 19; // 16 B to 4 MB, powers of two
+		static constexpr size_t	  chunk_size  = 64 * 1024;
+		static constexpr uint32_t heap_class  = ~uint32_t(0);
+
+		// Precedes every block, keeps the payload 16-byte aligned
+		struct block_header
+		{
+			uint32_t m_class;
+			uint32_t m_reserved;
+			uint64_t m_size;
+		};
+
+		static_assert(sizeof(block_header) == 16, "block header must preserve alignment");
+
+		struct free_block
+		{
+			free_block* m_next;
+		};
+
+		struct atomic_counters
+		{
+			std::atomic<int64_t> m_allocations{0};
+			std::atomic<int64_t> m_bytes{0};
+			std::atomic<int64_t> m_heap_allocations{0};
+
+			frame_counters load() const
+			{
+				frame_counters result;
+				result.m_allocations	  = m_allocations.load(std::memory_order_relaxed);
+				result.m_bytes			  = m_bytes.load(std::memory_order_relaxed);
+				result.m_heap_allocations = m_heap_allocations.load(std::memory_order_relaxed);
+				return result;
+			}
+
+			void store(const frame_counters& c)
+			{
+				m_allocations.store(c.m_allocations, std::memory_order_relaxed);
+				m_bytes.store(c.m_bytes, std::memory_order_relaxed);
+				m_heap_allocations.store(c.m_heap_allocations, std::memory_order_relaxed);
+			}
+
+			frame_counters exchange_zero()
+			{
+				frame_counters result;
+				result.m_allocations	  = m_allocations.exchange(0, std::memory_order_relaxed);
+				result.m_bytes			  = m_bytes.exchange(0, std::memory_order_relaxed);
+				result.m_heap_allocations = m_heap_allocations.exchange(0, std::memory_order_relaxed);
+				return result;
+			}
+		};
+
+		struct pool_allocator
+		{
+			std::mutex							 m_mutex;
+			std::array<free_block*, class_count> m_free{};
+
+			std::array<atomic_counters, phase_count> m_current;
+			std::array<atomic_counters, phase_count> m_last;
+
+			std::atomic<int64_t> m_live_bytes{0};
+			std::atomic<int64_t> m_peak_live_bytes{0};
+			std::atomic<int64_t> m_reserved_bytes{0};
+
+			static uint32_t class_for(size_t total)
+			{
+				for (uint32_t c = 0; c < uint32_t(class_count); ++c)
+				{
+					if ((min_block << c) >= total)
+					{
+						return c;
+					}
+				}
+				return heap_class;
+			}
+
+			// Carves a fresh malloc'd chunk into blocks of one class. Chunks live as long as the process.
+			bool refill(uint32_t c)
+			{
+				const size_t block = min_block << c;
+				const size_t count = block >= chunk_size ? 1 : chunk_size / block;
+
+				uint8_t* chunk = static_cast<uint8_t*>(std::malloc(block * count));
+				if (chunk == nullptr)
+				{
+					return false;
+				}
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					free_block* b = reinterpret_cast<free_block*>(chunk + i * block);
+					b->m_next	  = m_free[c];
+					m_free[c]	  = b;
+				}
+
+				m_reserved_bytes.fetch_add(int64_t(block * count), std::memory_order_relaxed);
+				return true;
+			}
+
+			void* alloc(size_t size)
+			{
+				atomic_counters& counters = m_current[int(frame_stats::current_phase())];
+				counters.m_allocations.fetch_add(1, std::memory_order_relaxed);
+				counters.m_bytes.fetch_add(int64_t(size), std::memory_order_relaxed);
+
+				const size_t   total = size + sizeof(block_header);
+				const uint32_t c	 = class_for(total);
+				block_header*  header;
+
+				if (c == heap_class)
+				{
+					counters.m_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+					header = static_cast<block_header*>(std::malloc(total));
+				}
+				else
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					if (m_free[c] == nullptr)
+					{
+						counters.m_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+						if (!refill(c))
+						{
+							return nullptr;
+						}
+					}
+
+					free_block* b = m_free[c];
+					m_free[c]	  = b->m_next;
+					header		  = reinterpret_cast<block_header*>(b);
+				}
+
+				if (header == nullptr)
+				{
+					return nullptr;
+				}
+
+				header->m_class	   = c;
+				header->m_reserved = 0;
+				header->m_size	   = size;
+
+				const int64_t live = m_live_bytes.fetch_add(int64_t(size), std::memory_order_relaxed) + int64_t(size);
+				int64_t		  peak = m_peak_live_bytes.load(std::memory_order_relaxed);
+				while (live > peak && !m_peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+				{
+				}
+
+				return header + 1;
+			}
+
+			void free(void* ptr)
+			{
+				if (ptr == nullptr)
+				{
+					return;
+				}
+
+				block_header* header = static_cast<block_header*>(ptr) - 1;
+				m_live_bytes.fetch_sub(int64_t(header->m_size), std::memory_order_relaxed);
+
+				if (header->m_class == heap_class)
+				{
+					std::free(header);
+					return;
+				}
+
+				std::lock_guard<std::mutex> lock(m_mutex);
+				free_block*					b = reinterpret_cast<free_block*>(header);
+				b->m_next					  = m_free[header->m_class];
+				m_free[header->m_class]		  = b;
+			}
+
+			void commit()
+			{
+				for (int i = 0; i < phase_count; ++i)
+				{
+					m_last[i].store(m_current[i].exchange_zero());
+				}
+			}
+		};
+
+		static pool_allocator g_allocator;
+
+		void install()
+		{
+			// init() and every app::init() get here, possibly from different threads
+			static std::once_flag once;
+			std::call_once(once, []() {
+				ImGui::SetAllocatorFunctions(
+					[](size_t size, void*) -> void* { return g_allocator.alloc(size); }, [](void* ptr, void*) -> void { g_allocator.free(ptr); }, nullptr);
+			});
+		}
+
+		void commit_frame()
+		{
+			g_allocator.commit();
+		}
+
+		frame_counters last_frame(frame_stats::phase p)
+		{
+			const int index = int(p);
+			if (index < 0 || index >= phase_count)
+			{
+				return {};
+			}
+			return g_allocator.m_last[index].load();
+		}
+
+		frame_counters last_frame_total()
+		{
+			frame_counters total;
+			for (int i = 0; i < phase_count; ++i)
+			{
+				const frame_counters c = g_allocator.m_last[i].load();
+				total.m_allocations += c.m_allocations;
+				total.m_bytes += c.m_bytes;
+				total.m_heap_allocations += c.m_heap_allocations;
+			}
+			return total;
+		}
+
+		heap_state current_heap()
+		{
+			heap_state result;
+			result.m_live_bytes		 = g_allocator.m_live_bytes.load(std::memory_order_relaxed);
+			result.m_peak_live_bytes = g_allocator.m_peak_live_bytes.load(std::memory_order_relaxed);
+			result.m_reserved_bytes	 = g_allocator.m_reserved_bytes.load(std::memory_order_relaxed);
+			return result;
+		}
+
+		void reset_peak()
+		{
+			g_allocator.m_peak_live_bytes.store(g_allocator.m_live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+	}
+}
@@ -0,0 +1,519 @@
+#include "imgui_app_fw_impl.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace imgui_app_fw
+{
+	namespace gpu_timing
+	{
+		// Spans arrive from the render threads in the order their slots are read back. m_pending collects them until
+		// commit() publishes the frame, m_history keeps the most recent ones for traces. Only init()/pump() commits, so a
+		// process running apps alone would grow m_pending forever; it keeps at most max_pending spans, dropping the oldest.
+		static constexpr size_t max_pending = history_size;
+
+		struct span_log
+		{
+			std::mutex					   m_mutex;
+			std::vector<span>			   m_pending;
+			std::vector<span>			   m_last;
+			std::array<span, history_size> m_history;
+			uint64_t					   m_history_count = 0;
+			double						   m_origin_ms	   = 0.0;
+			bool						   m_has_origin	   = false;
+			std::atomic<bool>			   m_enabled{false};
+			std::atomic<bool>			   m_per_draw_list{false};
+
+			void commit()
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_last.swap(m_pending);
+				m_pending.clear();
+			}
+		};
+
+		static span_log g_log;
+
+		void set_enabled(bool enabled, bool per_draw_list)
+		{
+			g_log.m_per_draw_list = per_draw_list;
+			g_log.m_enabled		  = enabled;
+		}
+
+		bool enabled()
+		{
+			return g_log.m_enabled;
+		}
+
+		bool per_draw_list()
+		{
+			return g_log.m_per_draw_list;
+		}
+
+		void add(const span& s)
+		{
+			std::lock_guard<std::mutex> lock(g_log.m_mutex);
+			if (!g_log.m_has_origin)
+			{
+				g_log.m_origin_ms  = s.m_start_ms;
+				g_log.m_has_origin = true;
+			}
+
+			if (g_log.m_pending.size() >= max_pending)
+			{
+				g_log.m_pending.erase(g_log.m_pending.begin(), g_log.m_pending.begin() + max_pending / 2);
+			}
+
+			span& relative		= g_log.m_pending.emplace_back(s);
+			relative.m_start_ms = s.m_start_ms - g_log.m_origin_ms;
+			relative.m_end_ms	= s.m_end_ms - g_log.m_origin_ms;
+
+			g_log.m_history[g_log.m_history_count++ % history_size] = relative;
+		}
+
+		void set_name(span& s, const char* name)
+		{
+			size_t length = std::strlen(name);
+			if (length >= sizeof(s.m_name))
+			{
+				// back up over UTF-8 continuation bytes so the cut doesn't split a code point
+				length = sizeof(s.m_name) - 1;
+				while (length > 0 && (static_cast<unsigned char>(name[length]) & 0xC0) == 0x80)
+				{
+					--length;
+				}
+			}
+			std::memcpy(s.m_name, name, length);
+			s.m_name[length] = 0;
+		}
+
+		int last_frame(span* spans, int max_count)
+		{
+			std::lock_guard<std::mutex> lock(g_log.m_mutex);
+			const int					count = std::min(int(g_log.m_last.size()), std::max(max_count, 0));
+			std::copy(g_log.m_last.begin(), g_log.m_last.begin() + count, spans);
+			return count;
+		}
+
+		double last_frame_ms()
+		{
+			std::lock_guard<std::mutex> lock(g_log.m_mutex);
+			double						total = 0.0;
+			for (const span& s : g_log.m_last)
+			{
+				if (s.m_depth == 0)
+				{
+					total += s.m_end_ms - s.m_start_ms;
+				}
+			}
+			return total;
+		}
+
+		void write_chrome_trace(std::FILE* out)
+		{
+			std::lock_guard<std::mutex> lock(g_log.m_mutex);
+
+			const uint64_t count = std::min<uint64_t>(g_log.m_history_count, history_size);
+			const uint64_t first = g_log.m_history_count - count;
+
+			std::fprintf(out, "{\"traceEvents\":[\n");
+			for (uint64_t i = 0; i < count; ++i)
+			{
+				const span& s = g_log.m_history[(first + i) % history_size];
+
+				// names come from window titles, keep only what needs no escaping
+				char name[sizeof(s.m_name)];
+				int	 length = 0;
+				for (const char* c = s.m_name; *c && length < int(sizeof(name)) - 1; ++c)
+				{
+					name[length++] = (*c == '"' || *c == '\\' || (unsigned char)(*c) < 0x20) ? '_' : *c;
+				}
+				name[length] = 0;
+
+				std::fprintf(out, "{\"name\":\"%s\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n", name, s.m_viewport_id,
+					s.m_start_ms * 1000.0, (s.m_end_ms - s.m_start_ms) * 1000.0, i + 1 < count ? "," : "");
+			}
+			std::fprintf(out, "],\"displayTimeUnit\":\"ms\"}\n");
+		}
+	}
+
+	namespace frame_stats
+	{
+		static constexpr int phase_count = int(phase::count);
+
+		// Single-writer ring buffer. commit_frame() fills the slot for frame N and then publishes N + 1 through m_committed,
+		// readers only look at slots older than the one that may be in flight, so every value they see is a complete store.
+		struct frame_ring
+		{
+			using clock = std::chrono::steady_clock;
+
+			struct slot
+			{
+				std::array<std::atomic<int64_t>, phase_count> m_ns;
+			};
+
+			std::array<slot, history_size>				  m_slots;
+			std::array<std::atomic<int64_t>, phase_count> m_pending;
+			std::atomic<uint64_t>						  m_committed{0};
+			std::atomic<uint64_t>						  m_first_valid{0};
+			std::atomic<int64_t>						  m_pending_commands{0};
+			std::atomic<int64_t>						  m_pending_draws{0};
+			std::atomic<int64_t>						  m_last_commands{0};
+			std::atomic<int64_t>						  m_last_draws{0};
+			std::atomic<int64_t>						  m_pending_geometry_written{0};
+			std::atomic<int64_t>						  m_pending_geometry_reused{0};
+			std::atomic<int64_t>						  m_last_geometry_written{0};
+			std::atomic<int64_t>						  m_last_geometry_reused{0};
+			clock::time_point							  m_last_commit;
+			bool										  m_has_last_commit = false;
+
+			frame_ring()
+			{
+				for (auto& s : m_slots)
+				{
+					for (auto& v : s.m_ns)
+					{
+						v.store(0, std::memory_order_relaxed);
+					}
+				}
+
+				for (auto& v : m_pending)
+				{
+					v.store(0, std::memory_order_relaxed);
+				}
+			}
+
+			void commit()
+			{
+				const auto now = clock::now();
+				if (m_has_last_commit)
+				{
+					m_pending[int(phase::frame)].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_last_commit).count(), std::memory_order_relaxed);
+				}
+				m_last_commit	  = now;
+				m_has_last_commit = true;
+
+				const uint64_t frame = m_committed.load(std::memory_order_relaxed);
+				slot&		   s	 = m_slots[frame % history_size];
+
+				for (int i = 0; i < phase_count; ++i)
+				{
+					s.m_ns[i].store(m_pending[i].exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+				}
+
+				m_last_commands.store(m_pending_commands.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+				m_last_draws.store(m_pending_draws.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+				m_last_geometry_written.store(m_pending_geometry_written.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+				m_last_geometry_reused.store(m_pending_geometry_reused.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+
+				m_committed.store(frame + 1, std::memory_order_release);
+			}
+		};
+
+		static frame_ring g_ring;
+
+		static thread_local phase t_current_phase = phase::frame;
+
+		phase current_phase()
+		{
+			return t_current_phase;
+		}
+
+		phase exchange_current_phase(phase p)
+		{
+			const phase previous = t_current_phase;
+			t_current_phase		 = p;
+			return previous;
+		}
+
+		const char* phase_name(phase p)
+		{
+			switch (p)
+			{
+			case phase::frame:
+				return "frame";
+			case phase::pump:
+				return "pump";
+			case phase::idle:
+				return "idle";
+			case phase::new_frame:
+				return "new_frame";
+			case phase::ui_build:
+				return "ui_build";
+			case phase::render:
+				return "render";
+			case phase::draw:
+				return "draw";
+			case phase::execute:
+				return "execute";
+			case phase::present:
+				return "present";
+			default:
+				return "unknown";
+			}
+		}
+
+		summary query(phase p, int frames)
+		{
+			summary result;
+
+			const int index = int(p);
+			if (index < 0 || index >= phase_count)
+			{
+				return result;
+			}
+
+			const uint64_t committed   = g_ring.m_committed.load(std::memory_order_acquire);
+			const uint64_t first_valid = std::min(g_ring.m_first_valid.load(std::memory_order_relaxed), committed);
+			const uint64_t available   = std::min<uint64_t>(committed - first_valid, history_size - 1);
+			const int	   count	   = int(std::min<uint64_t>(available, uint64_t(std::max(frames, 0))));
+
+			if (count == 0)
+			{
+				return result;
+			}
+
+			std::array<int64_t, history_size> values;
+			int64_t							  total = 0;
+
+			for (int i = 0; i < count; ++i)
+			{
+				const uint64_t frame = committed - 1 - i;
+				values[i]			 = g_ring.m_slots[frame % history_size].m_ns[index].load(std::memory_order_relaxed);
+				total += values[i];
+			}
+
+			constexpr double ns_to_ms = 1.0e-6;
+
+			result.m_frames	 = count;
+			result.m_last_ms = values[0] * ns_to_ms;
+			result.m_avg_ms	 = (double(total) / count) * ns_to_ms;
+			result.m_min_ms	 = *std::min_element(values.begin(), values.begin() + count) * ns_to_ms;
+			result.m_max_ms	 = *std::max_element(values.begin(), values.begin() + count) * ns_to_ms;
+
+			const int p99 = std::min(count - 1, int(double(count) * 0.99));
+			std::nth_element(values.begin(), values.begin() + p99, values.begin() + count);
+			result.m_p99_ms = values[p99] * ns_to_ms;
+
+			return result;
+		}
+
+		void reset()
+		{
+			g_ring.m_first_valid.store(g_ring.m_committed.load(std::memory_order_acquire), std::memory_order_relaxed);
+		}
+
+		void add(phase p, int64_t nanoseconds)
+		{
+			const int index = int(p);
+			if (index >= 0 && index < phase_count)
+			{
+				g_ring.m_pending[index].fetch_add(nanoseconds, std::memory_order_relaxed);
+			}
+		}
+
+		void add_draws(int64_t commands, int64_t draws)
+		{
+			g_ring.m_pending_commands.fetch_add(commands, std::memory_order_relaxed);
+			g_ring.m_pending_draws.fetch_add(draws, std::memory_order_relaxed);
+		}
+
+		void add_geometry(int64_t written_bytes, int64_t reused_bytes)
+		{
+			g_ring.m_pending_geometry_written.fetch_add(written_bytes, std::memory_order_relaxed);
+			g_ring.m_pending_geometry_reused.fetch_add(reused_bytes, std::memory_order_relaxed);
+		}
+
+		draw_counters last_frame_draws()
+		{
+			draw_counters result;
+			result.m_commands		  = g_ring.m_last_commands.load(std::memory_order_relaxed);
+			result.m_draws			  = g_ring.m_last_draws.load(std::memory_order_relaxed);
+			result.m_geometry_written = g_ring.m_last_geometry_written.load(std::memory_order_relaxed);
+			result.m_geometry_reused  = g_ring.m_last_geometry_reused.load(std::memory_order_relaxed);
+			return result;
+		}
+
+		void commit_frame()
+		{
+			g_ring.commit();
+			gpu_timing::g_log.commit();
+		}
+	}
+
+	namespace startup
+	{
+		using clock = std::chrono::steady_clock;
+
+		// Steps claim a slot with m_count and publish it by storing m_name last, readers skip slots without a name
+		struct timeline
+		{
+			struct slot
+			{
+				std::atomic<const char*> m_name{nullptr};
+				std::atomic<int64_t>	 m_start_ns{0};
+				std::atomic<int64_t>	 m_end_ns{-1}; // -1 while running
+				std::atomic<int>		 m_thread{0};
+			};
+
+			std::array<slot, max_steps> m_slots;
+			std::atomic<int>			m_count{0};
+			std::atomic<bool>			m_open{false};
+			std::atomic<int64_t>		m_origin{0}; // clock ticks of the init() call
+			std::atomic<int64_t>		m_first_frame_ns{0};
+			std::atomic<int64_t>		m_init_end_ns{0};
+			std::atomic<uint32_t>		m_generation{0};
+			std::atomic<int>			m_next_thread{1};
+
+			int64_t elapsed_ns() const
+			{
+				const auto ticks = clock::duration(clock::now().time_since_epoch().count() - m_origin.load(std::memory_order_relaxed));
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(ticks).count();
+			}
+		};
+
+		static timeline g_timeline;
+
+		struct thread_lane
+		{
+			uint32_t m_generation = ~uint32_t(0);
+			int		 m_id		  = 0;
+		};
+
+		static thread_local thread_lane t_lane;
+
+		static int current_thread_id()
+		{
+			const uint32_t generation = g_timeline.m_generation.load(std::memory_order_relaxed);
+			if (t_lane.m_generation != generation)
+			{
+				t_lane.m_generation = generation;
+				t_lane.m_id			= g_timeline.m_next_thread.fetch_add(1, std::memory_order_relaxed);
+			}
+			return t_lane.m_id;
+		}
+
+		static int record(const char* name, int64_t start_ns, int64_t end_ns)
+		{
+			const int index = g_timeline.m_count.fetch_add(1, std::memory_order_relaxed);
+			if (index >= max_steps)
+			{
+				return -1;
+			}
+
+			timeline::slot& s = g_timeline.m_slots[index];
+			s.m_start_ns.store(start_ns, std::memory_order_relaxed);
+			s.m_end_ns.store(end_ns, std::memory_order_relaxed);
+			s.m_thread.store(current_thread_id(), std::memory_order_relaxed);
+			s.m_name.store(name, std::memory_order_release);
+			return index;
+		}
+
+		void begin()
+		{
+			g_timeline.m_open = false;
+			for (timeline::slot& s : g_timeline.m_slots)
+			{
+				s.m_name.store(nullptr, std::memory_order_relaxed);
+			}
+
+			g_timeline.m_count			= 0;
+			g_timeline.m_first_frame_ns = 0;
+			g_timeline.m_init_end_ns	= 0;
+			g_timeline.m_next_thread	= 1;
+			g_timeline.m_origin			= clock::now().time_since_epoch().count();
+
+			t_lane.m_generation = g_timeline.m_generation.fetch_add(1) + 1;
+			t_lane.m_id			= 0;
+			g_timeline.m_open	= true;
+		}
+
+		void end_init()
+		{
+			if (g_timeline.m_open)
+			{
+				g_timeline.m_init_end_ns = g_timeline.elapsed_ns();
+			}
+		}
+
+		void first_frame_done()
+		{
+			if (g_timeline.m_open.exchange(false))
+			{
+				const int64_t now = g_timeline.elapsed_ns();
+				g_timeline.m_first_frame_ns.store(now);
+				record("first_frame", g_timeline.m_init_end_ns.load(), now);
+			}
+		}
+
+		scoped_step::scoped_step(const char* name) : m_slot{-1}
+		{
+			if (g_timeline.m_open.load(std::memory_order_relaxed))
+			{
+				m_slot = record(name, g_timeline.elapsed_ns(), -1);
+			}
+		}
+
+		scoped_step::~scoped_step()
+		{
+			if (m_slot >= 0)
+			{
+				g_timeline.m_slots[m_slot].m_end_ns.store(g_timeline.elapsed_ns(), std::memory_order_relaxed);
+			}
+		}
+
+		int query(step* steps, int max_count)
+		{
+			constexpr double ns_to_ms = 1.0e-6;
+
+			const int recorded = std::min(g_timeline.m_count.load(), max_steps);
+			int		  count	   = 0;
+
+			for (int i = 0; i < recorded && count < max_count; ++i)
+			{
+				const timeline::slot& s	   = g_timeline.m_slots[i];
+				const char*			  name = s.m_name.load(std::memory_order_acquire);
+				if (!name)
+				{
+					continue;
+				}
+
+				const int64_t start_ns = s.m_start_ns.load(std::memory_order_relaxed);
+				const int64_t end_ns   = s.m_end_ns.load(std::memory_order_relaxed);
+
+				step& out	   = steps[count++];
+				out.m_name	   = name;
+				out.m_start_ms = start_ns * ns_to_ms;
+				out.m_end_ms   = (end_ns < 0 ? start_ns : end_ns) * ns_to_ms;
+				out.m_thread   = s.m_thread.load(std::memory_order_relaxed);
+			}
+
+			std::stable_sort(steps, steps + count, [](const step& a, const step& b) { return a.m_start_ms < b.m_start_ms; });
+			return count;
+		}
+
+		double time_to_first_frame_ms()
+		{
+			return g_timeline.m_first_frame_ns.load() * 1.0e-6;
+		}
+
+		void print(std::FILE* out)
+		{
+			std::array<step, max_steps> steps;
+			const int					count = query(steps.data(), max_steps);
+
+			std::fprintf(out, "startup: %.1f ms to first frame\n", time_to_first_frame_ms());
+			for (int i = 0; i < count; ++i)
+			{
+				const step& s = steps[i];
+				std::fprintf(out, "  %8.1f %8.1f ms  %7.1f ms  thread %d  %s\n", s.m_start_ms, s.m_end_ms, s.m_end_ms - s.m_start_ms, s.m_thread, s.m_name);
+			}
+		}
+	}
+}
@@ -143,7 +143,7 @@ void end_frame_gui_win32_dx11(ImVec4 clear_color)
     ImGui::Render();
     g_pd3dDeviceContext->OMSetRenderTargets(1, &g_mainRenderTargetView, NULL);
     g_pd3dDeviceContext->ClearRenderTargetView(g_mainRenderTargetView, (float*)&clear_color);
-    ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+    ImGui_ImplDX11_RenderDrawData(imgui_app_fw::process_frame_draw_data(ImGui::GetDrawData()));
 
     ImGuiIO& io = ImGui::GetIO();
 
@@ -68,7 +68,7 @@ struct gui_primary_context
 		m_command_list->ClearRenderTargetView(m_main_render_target_descriptor[back_buffer_index], (float*)&clear_color, 0, NULL);
 		m_command_list->OMSetRenderTargets(1, &m_main_render_target_descriptor[back_buffer_index], FALSE, NULL);
 		ImGui::Render();
-		g_shared_state.RenderDrawData(ImGui::GetDrawData(), m_command_list);
+		g_shared_state.RenderDrawData(imgui_app_fw::process_frame_draw_data(ImGui::GetDrawData()), m_command_list);
 		barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
 		barrier.Transition.StateAfter  = D3D12_RESOURCE_STATE_PRESENT;
 		m_command_list->ResourceBarrier(1, &barrier);